@@ -0,0 +1,311 @@
+/*==============================================================================
+checkpoint.c : checkpoints of GA runs
+(C) 2006-2017 Jens Kleinjung
+(C) 2006-2007 Alessandro Pandini
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+==============================================================================*/
+
+/* A checkpoint holds the state of all islands of a GA run at the end of a
+	generation: genomes, fitness and fitness memo. Random number streams are
+	derived from the seed, run, generation and genome slot, so no generator
+	state needs to be stored, and parent counts for incremental scoring are
+	rebuilt after the first generation of a resumed run.
+	File layout: Checkhead, then for each island: genomes ('row' bytes each,
+	in pool order), fitness, memo keys, memo hashes, memo fitness, memo states,
+	memo hits and misses. Files are written to a temporary file and renamed,
+	so that a checkpoint file is always complete. */
+
+#include <unistd.h>
+
+#include "ga.h"
+#include "checkpoint.h"
+
+/*____________________________________________________________________________*/
+/* genome at pool position 'ix' */
+static void *genome_at(Pool *pool, int ix)
+{
+#ifdef BIT
+	return pool_bitgenome(pool, ix);
+#else
+	return pool_genome(pool, ix);
+#endif
+}
+
+/*____________________________________________________________________________*/
+/* write the complete checkpoint, keeping the previous one if that fails */
+static void write_checkpoint(Checkpoint *ck)
+{
+	int i;
+	int ok;
+	char tmpFileName[sizeof(ck->fileName) + 4];
+	Checkhead *head = &ck->head;
+	Checkisland *is;
+	FILE *file;
+
+	sprintf(tmpFileName, "%s.tmp", ck->fileName);
+	if ((file = fopen(tmpFileName, "wb")) == 0)
+	{
+		fprintf(stderr, "Warning: cannot write checkpoint %s\n", tmpFileName);
+		return;
+	}
+
+	ok = (fwrite(head, sizeof(Checkhead), 1, file) == 1);
+	for (i = 0; i < ck->n_island && ok; ++ i)
+	{
+		is = &ck->island[i];
+		ok = (fwrite(is->genome, head->row, head->popsize, file) == head->popsize &&
+			fwrite(is->fitness, sizeof(float), head->popsize, file) == head->popsize &&
+			fwrite(is->memo.key, sizeof(uint64_t) * head->memo_n_word, head->memo_size, file) == head->memo_size &&
+			fwrite(is->memo.hash, sizeof(uint64_t) * 2, head->memo_size, file) == head->memo_size &&
+			fwrite(is->memo.fitness, sizeof(float), head->memo_size, file) == head->memo_size &&
+			fwrite(is->memo.state, sizeof(char), head->memo_size, file) == head->memo_size &&
+			fwrite(&is->memo.hit, sizeof(long), 1, file) == 1 &&
+			fwrite(&is->memo.miss, sizeof(long), 1, file) == 1);
+	}
+	ok = (fflush(file) == 0 && fsync(fileno(file)) == 0 && ok);
+	ok = (fclose(file) == 0 && ok);
+
+	if (! ok || rename(tmpFileName, ck->fileName) != 0)
+	{
+		fprintf(stderr, "Warning: cannot write checkpoint %s\n", ck->fileName);
+		remove(tmpFileName);
+	}
+}
+
+/*____________________________________________________________________________*/
+/* writer thread: write each complete checkpoint while the islands evolve */
+static void *checkpoint_writer(void *pck)
+{
+	Checkpoint *ck = (Checkpoint *)pck;
+
+	pthread_mutex_lock(&ck->lock);
+	while (1)
+	{
+		while (! ck->writing && ! ck->stop)
+			pthread_cond_wait(&ck->cond, &ck->lock);
+		if (! ck->writing)
+			break;
+
+		pthread_mutex_unlock(&ck->lock);
+		write_checkpoint(ck);
+		pthread_mutex_lock(&ck->lock);
+
+		ck->writing = 0;
+		pthread_cond_broadcast(&ck->cond);
+	}
+	pthread_mutex_unlock(&ck->lock);
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/* start checkpointing run 'j', 'k' to file 'fileName' */
+void init_checkpoint(Checkpoint *ck, Gapar *gaPar, const char *fileName, int j, int k)
+{
+	int i;
+
+	assert(strlen(fileName) < sizeof(ck->fileName));
+	strcpy(ck->fileName, fileName);
+
+	memset(&ck->head, 0, sizeof(Checkhead));
+	memcpy(ck->head.magic, CHECKPOINT_MAGIC, sizeof(ck->head.magic));
+	ck->head.version = CHECKPOINT_VERSION;
+	ck->head.seed = gaPar->seed;
+	ck->head.popsize = gaPar->popsize;
+	ck->head.fitmate = gaPar->fitmate;
+	ck->head.genenum = gaPar->genenum;
+	ck->head.islands = gaPar->islands;
+	ck->head.migration = gaPar->migration;
+	ck->head.repeat = gaPar->repeat;
+	ck->head.jackknife = gaPar->jackknife;
+	ck->head.j = j;
+	ck->head.k = k;
+	ck->head.l = -1;
+#ifdef BIT
+	ck->head.row = BITWORDS(gaPar->genenum) * sizeof(uint64_t);
+#else
+	ck->head.row = gaPar->genenum * sizeof(int);
+#endif
+
+	/* snapshots; memo buffers are allocated with the first snapshot */
+	ck->n_island = gaPar->islands;
+	ck->island = safe_malloc(ck->n_island * sizeof(Checkisland));
+	ck->count = safe_malloc(ck->n_island * sizeof(int));
+	for (i = 0; i < ck->n_island; ++ i)
+	{
+		ck->island[i].genome = safe_malloc((size_t)gaPar->popsize * ck->head.row);
+		ck->island[i].fitness = safe_malloc(gaPar->popsize * sizeof(float));
+		ck->island[i].memo.size = 0;
+		ck->count[i] = 0;
+	}
+
+	ck->done = 0;
+	ck->arrived = 0;
+	ck->writing = 0;
+	ck->stop = 0;
+	pthread_mutex_init(&ck->lock, 0);
+	pthread_cond_init(&ck->cond, 0);
+
+	if (pthread_create(&ck->writer, 0, checkpoint_writer, ck) != 0)
+	{
+		fprintf(stderr, "Exiting: cannot create checkpoint thread\n");
+		exit(1);
+	}
+}
+
+/*____________________________________________________________________________*/
+/* store the state of 'island' after generation 'l'; the checkpoint is written */
+/* in the background once all islands have stored their state */
+void save_checkpoint(Checkpoint *ck, int island, Pool *pool, Memo *memo, int l)
+{
+	int i;
+	int n = ++ ck->count[island]; /* number of this checkpoint */
+	Checkisland *is = &ck->island[island];
+
+	/* wait for the previous checkpoint to be complete and written */
+	pthread_mutex_lock(&ck->lock);
+	while (ck->writing || ck->done != n - 1)
+		pthread_cond_wait(&ck->cond, &ck->lock);
+	pthread_mutex_unlock(&ck->lock);
+
+	for (i = 0; i < ck->head.popsize; ++ i)
+	{
+		memcpy(&is->genome[(size_t)i * ck->head.row], genome_at(pool, i), ck->head.row);
+		is->fitness[i] = pool->fitness[i];
+	}
+
+	if (is->memo.size == 0)
+	{
+		is->memo = *memo;
+		is->memo.key = safe_malloc(memo->size * memo->n_word * sizeof(uint64_t));
+		is->memo.hash = safe_malloc(memo->size * 2 * sizeof(uint64_t));
+		is->memo.fitness = safe_malloc(memo->size * sizeof(float));
+		is->memo.state = safe_malloc(memo->size * sizeof(char));
+		is->memo.scratch = 0;
+	}
+	memcpy(is->memo.key, memo->key, memo->size * memo->n_word * sizeof(uint64_t));
+	memcpy(is->memo.hash, memo->hash, memo->size * 2 * sizeof(uint64_t));
+	memcpy(is->memo.fitness, memo->fitness, memo->size * sizeof(float));
+	memcpy(is->memo.state, memo->state, memo->size * sizeof(char));
+	is->memo.hit = memo->hit;
+	is->memo.miss = memo->miss;
+
+	/* the last island hands the checkpoint over to the writer */
+	pthread_mutex_lock(&ck->lock);
+	ck->head.l = l;
+	ck->head.memo_size = memo->size;
+	ck->head.memo_n_word = memo->n_word;
+	if (++ ck->arrived == ck->n_island)
+	{
+		ck->arrived = 0;
+		++ ck->done;
+		ck->writing = 1;
+		pthread_cond_broadcast(&ck->cond);
+	}
+	pthread_mutex_unlock(&ck->lock);
+}
+
+/*____________________________________________________________________________*/
+/* stop checkpointing after the last checkpoint is written; the checkpoint */
+/* file is kept until the caller has written the results of the run */
+void finish_checkpoint(Checkpoint *ck)
+{
+	int i;
+
+	pthread_mutex_lock(&ck->lock);
+	ck->stop = 1;
+	pthread_cond_broadcast(&ck->cond);
+	pthread_mutex_unlock(&ck->lock);
+	pthread_join(ck->writer, 0);
+
+	pthread_mutex_destroy(&ck->lock);
+	pthread_cond_destroy(&ck->cond);
+	for (i = 0; i < ck->n_island; ++ i)
+	{
+		free(ck->island[i].genome);
+		free(ck->island[i].fitness);
+		if (ck->island[i].memo.size > 0)
+		{
+			free(ck->island[i].memo.key);
+			free(ck->island[i].memo.hash);
+			free(ck->island[i].memo.fitness);
+			free(ck->island[i].memo.state);
+		}
+	}
+	free(ck->island);
+	free(ck->count);
+}
+
+/*____________________________________________________________________________*/
+/* read the header of checkpoint file 'fileName' */
+void read_checkhead(const char *fileName, Checkhead *head)
+{
+	FILE *file = safe_open(fileName, "rb");
+
+	if (fread(head, sizeof(Checkhead), 1, file) != 1 ||
+		memcmp(head->magic, CHECKPOINT_MAGIC, sizeof(head->magic)) != 0)
+	{
+		fprintf(stderr, "Exiting: %s is not a checkpoint file\n", fileName);
+		exit(1);
+	}
+	if (head->version != CHECKPOINT_VERSION)
+	{
+		fprintf(stderr, "Exiting: checkpoint %s has version %d, expected %d\n",
+			fileName, head->version, CHECKPOINT_VERSION);
+		exit(1);
+	}
+
+	fclose(file);
+}
+
+/*____________________________________________________________________________*/
+/* restore the pool and memo of 'island' from checkpoint file 'fileName', */
+/* whose header is 'head'; the pool is in its initial order */
+void load_checkpoint(const char *fileName, Checkhead *head, int island, Pool *pool, Memo *memo)
+{
+	int i;
+	int ok;
+	long offset = sizeof(Checkhead);
+	long island_bytes = (long)head->popsize * (head->row + sizeof(float)) +
+		(long)head->memo_size * ((head->memo_n_word + 2) * sizeof(uint64_t) + sizeof(float) + sizeof(char)) +
+		2 * sizeof(long);
+	FILE *file = safe_open(fileName, "rb");
+
+	if (head->memo_size != memo->size || head->memo_n_word != memo->n_word)
+	{
+		fprintf(stderr, "Exiting: fitness memo of checkpoint %s does not match\n", fileName);
+		exit(1);
+	}
+
+	ok = (fseek(file, offset + island * island_bytes, SEEK_SET) == 0);
+	for (i = 0; i < head->popsize && ok; ++ i)
+		ok = (fread(genome_at(pool, i), head->row, 1, file) == 1);
+	ok = (ok && fread(pool->fitness, sizeof(float), head->popsize, file) == head->popsize &&
+		fread(memo->key, sizeof(uint64_t) * memo->n_word, memo->size, file) == memo->size &&
+		fread(memo->hash, sizeof(uint64_t) * 2, memo->size, file) == memo->size &&
+		fread(memo->fitness, sizeof(float), memo->size, file) == memo->size &&
+		fread(memo->state, sizeof(char), memo->size, file) == memo->size &&
+		fread(&memo->hit, sizeof(long), 1, file) == 1 &&
+		fread(&memo->miss, sizeof(long), 1, file) == 1);
+
+	if (! ok)
+	{
+		fprintf(stderr, "Exiting: cannot read island %d of checkpoint %s\n", island, fileName);
+		exit(1);
+	}
+
+	fclose(file);
+}
+
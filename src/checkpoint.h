@@ -0,0 +1,89 @@
+/*==============================================================================
+checkpoint.h : checkpoints of GA runs
+(C) 2006-2017 Jens Kleinjung
+(C) 2006-2007 Alessandro Pandini
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+==============================================================================*/
+
+#if !defined(CHECKPOINT_H)
+#define CHECKPOINT_H
+
+/*____________________________________________________________________________*/
+/* includes */
+#include "ga.h"
+
+/*____________________________________________________________________________*/
+/* defines */
+#define CHECKPOINT_MAGIC "MINSETCK" /* first 8 bytes of a checkpoint file */
+#define CHECKPOINT_VERSION 1 /* version of the checkpoint file layout */
+
+/*____________________________________________________________________________*/
+/* structures */
+
+/* header of a checkpoint file: the GA run and the dimensions of its data */
+typedef struct
+{
+	char magic[8]; /* CHECKPOINT_MAGIC, not terminated */
+	int version; /* CHECKPOINT_VERSION */
+	int seed; /* seed of random number streams */
+	int popsize; /* population size */
+	int fitmate; /* number of fittest genomes to mate */
+	int genenum; /* number of genes */
+	int islands; /* number of islands */
+	int migration; /* generations between migrations */
+	int repeat; /* number of repeats */
+	int jackknife; /* number of jackknife fractions */
+	int j, k; /* repeat and jackknife fraction of the run */
+	int l; /* last completed generation */
+	int row; /* bytes per genome */
+	int memo_size; /* number of memo slots */
+	int memo_n_word; /* words per memo key */
+} Checkhead;
+
+/* state of one island at the end of a generation */
+typedef struct
+{
+	char *genome; /* genomes in pool order, 'row' bytes each */
+	float *fitness; /* fitness in pool order */
+	Memo memo; /* fitness memo, without scratch space */
+} Checkisland;
+
+/* periodic checkpoints of one GA run: the islands store snapshots of their */
+/* state, a background thread writes complete checkpoints to file */
+typedef struct
+{
+	char fileName[64]; /* checkpoint file */
+	Checkhead head; /* header of the checkpoint being written */
+	Checkisland *island; /* snapshots of all islands */
+	int n_island; /* number of islands */
+	int *count; /* number of checkpoints started by each island */
+	int done; /* number of complete checkpoints */
+	int arrived; /* islands that stored the snapshot of the current checkpoint */
+	int writing; /* a complete checkpoint is being written */
+	int stop; /* the writer terminates after the last checkpoint */
+	pthread_mutex_t lock; /* protects the above */
+	pthread_cond_t cond; /* signals changes of the above */
+	pthread_t writer; /* writer thread */
+} Checkpoint;
+
+/*____________________________________________________________________________*/
+/* prototypes */
+void init_checkpoint(Checkpoint *ck, Gapar *gapar, const char *fileName, int j, int k);
+void save_checkpoint(Checkpoint *ck, int island, Pool *pool, Memo *memo, int l);
+void finish_checkpoint(Checkpoint *ck);
+void read_checkhead(const char *fileName, Checkhead *head);
+void load_checkpoint(const char *fileName, Checkhead *head, int island, Pool *pool, Memo *memo);
+
+#endif
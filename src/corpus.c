@@ -0,0 +1,263 @@
+/*==============================================================================
+corpus.c : binary corpus files of base sets
+(C) 2006-2017 Jens Kleinjung
+(C) 2006-2007 Alessandro Pandini
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+==============================================================================*/
+
+
+/* A corpus file replaces the list of sequence files of a base set: it is
+	written once from a parsed base set and memory-mapped at startup, so that
+	names, sequences and, for matching alphabet and k-word length, the
+	per-protein counts are used in place without reading or parsing. */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ga.h"
+#include "corpus.h"
+
+/*____________________________________________________________________________*/
+/* round 'offset' up to the next 8-byte boundary */
+static uint64_t align8(uint64_t offset)
+{
+	return (offset + 7) & ~(uint64_t)7;
+}
+
+/* write zero bytes up to file offset 'offset' */
+static int pad_to(FILE *file, uint64_t offset)
+{
+	while ((uint64_t)ftell(file) < offset)
+		if (fputc(0, file) == EOF)
+			return 0;
+
+	return 1;
+}
+
+/*____________________________________________________________________________*/
+/* 'size' bytes at 'offset' lie between 'begin' and 'end' */
+static int in_section(uint64_t offset, uint64_t size, uint64_t begin, uint64_t end)
+{
+	return (offset >= begin && offset <= end && size <= end - offset);
+}
+
+/* sections of the corpus header follow each other within the file of 'size' bytes */
+static int check_corpushead(const Corpushead *head, uint64_t size)
+{
+	if (head->n_prot < 0 || head->alphabet_size <= 0 || head->alphabet_size > 256 ||
+		memchr(head->alphabet, '\0', sizeof(head->alphabet)) == 0 ||
+		head->n_kword > size / sizeof(Kword) ||
+		head->entry % 8 != 0 || head->charcount % 8 != 0 || head->kword % 8 != 0)
+		return 0;
+
+	return (in_section(head->entry, (uint64_t)head->n_prot * sizeof(Corpusentry),
+			sizeof(Corpushead), size) &&
+		in_section(head->names, head->names_size,
+			head->entry + (uint64_t)head->n_prot * sizeof(Corpusentry), size) &&
+		in_section(head->residues, head->n_residue,
+			head->names + head->names_size, size) &&
+		in_section(head->charcount, (uint64_t)head->n_prot * head->alphabet_size * sizeof(int),
+			head->residues + head->n_residue, size) &&
+		in_section(head->kword, head->n_kword * sizeof(Kword),
+			head->charcount + (uint64_t)head->n_prot * head->alphabet_size * sizeof(int), size));
+}
+
+/* name, sequence and k-words of a corpus entry lie within their sections */
+static int check_corpusentry(const Corpushead *head, const Corpusentry *entry, const unsigned char *corpus)
+{
+	return (entry->name < head->names_size &&
+		memchr(corpus + head->names + entry->name, '\0', head->names_size - entry->name) != 0 &&
+		entry->length > 0 && entry->seq < head->n_residue &&
+		(uint64_t)entry->length < head->n_residue - entry->seq &&
+		corpus[head->residues + entry->seq + entry->length] == '\0' &&
+		entry->n_kword >= 0 && entry->n_all >= 0 && entry->kword <= head->n_kword &&
+		(uint64_t)entry->n_kword <= head->n_kword - entry->kword);
+}
+
+/*____________________________________________________________________________*/
+/* write the base set with its precomputed counts to corpus file 'fileName' */
+void pack_corpus(Minset *ms, const char *fileName)
+{
+	int i, j;
+	int ok = 1;
+	uint64_t name = 0;
+	uint64_t kword = 0;
+	Corpushead head;
+	Corpusentry entry;
+	Kword kw;
+	ProteinEntry *protein;
+	FILE *file = safe_open(fileName, "wb");
+
+	memset(&head, 0, sizeof(Corpushead));
+	memcpy(head.magic, CORPUS_MAGIC, sizeof(head.magic));
+	head.version = CORPUS_VERSION;
+	head.n_prot = ms->prots.n_prot;
+	assert(strlen(ms->alphabet.name) < sizeof(head.alphabet));
+	strcpy(head.alphabet, ms->alphabet.name);
+	head.alphabet_size = ms->alphabet.size;
+	head.kword_len = ms->kword_len;
+	head.score = CORPUS_SCORE;
+	for (i = 0; i < ms->prots.n_prot; ++ i)
+	{
+		head.names_size += strlen(ms->prots.protein[i].name) + 1;
+		head.n_kword += ms->prots.protein[i].kwords.n_kword;
+	}
+	head.n_residue = ms->prots.n_residue;
+
+	/* section layout */
+	head.entry = align8(sizeof(Corpushead));
+	head.names = align8(head.entry + head.n_prot * sizeof(Corpusentry));
+	head.residues = align8(head.names + head.names_size);
+	head.charcount = align8(head.residues + head.n_residue);
+	head.kword = align8(head.charcount + (uint64_t)head.n_prot * head.alphabet_size * sizeof(int));
+
+	ok = ok && fwrite(&head, sizeof(Corpushead), 1, file) == 1;
+
+	ok = ok && pad_to(file, head.entry);
+	for (i = 0; i < ms->prots.n_prot && ok; ++ i)
+	{
+		protein = &ms->prots.protein[i];
+		memset(&entry, 0, sizeof(Corpusentry));
+		entry.name = name;
+		entry.seq = protein->offset;
+		entry.kword = kword;
+		entry.length = protein->length;
+		entry.n_kword = protein->kwords.n_kword;
+		entry.n_all = protein->kwords.n_all;
+		entry.entropy = protein->entropy;
+		ok = fwrite(&entry, sizeof(Corpusentry), 1, file) == 1;
+
+		name += strlen(protein->name) + 1;
+		kword += protein->kwords.n_kword;
+	}
+
+	ok = ok && pad_to(file, head.names);
+	for (i = 0; i < ms->prots.n_prot && ok; ++ i)
+		ok = fwrite(ms->prots.protein[i].name, strlen(ms->prots.protein[i].name) + 1, 1, file) == 1;
+
+	ok = ok && pad_to(file, head.residues);
+	ok = ok && fwrite(ms->prots.residues, 1, head.n_residue, file) == head.n_residue;
+
+	ok = ok && pad_to(file, head.charcount);
+	for (i = 0; i < ms->prots.n_prot && ok; ++ i)
+		ok = fwrite(ms->prots.protein[i].charCount, sizeof(int), head.alphabet_size, file) == head.alphabet_size;
+
+	/* k-words one by one, with zeroed structure padding */
+	ok = ok && pad_to(file, head.kword);
+	for (i = 0; i < ms->prots.n_prot && ok; ++ i)
+	{
+		protein = &ms->prots.protein[i];
+		for (j = 0; j < protein->kwords.n_kword && ok; ++ j)
+		{
+			memset(&kw, 0, sizeof(Kword));
+			kw.code = protein->kwords.kword[j].code;
+			kw.count = protein->kwords.kword[j].count;
+			ok = fwrite(&kw, sizeof(Kword), 1, file) == 1;
+		}
+	}
+
+	if (fclose(file) != 0 || ! ok)
+	{
+		fprintf(stderr, "Exiting: cannot write corpus file %s\n", fileName);
+		exit(1);
+	}
+}
+
+/*____________________________________________________________________________*/
+/* map corpus file 'fileName' and set up the protein table in place; */
+/* counts are taken from the file if they match alphabet and k-word length */
+void load_corpus(Minset *ms, const char *fileName)
+{
+	int i;
+	int fd;
+	struct stat st;
+	const Corpushead *head;
+	const Corpusentry *entry;
+	ProteinEntry *protein;
+
+	if ((fd = open(fileName, O_RDONLY)) < 0 || fstat(fd, &st) != 0)
+	{
+		fprintf(stderr, "Exiting: cannot open corpus file %s\n", fileName);
+		exit(1);
+	}
+	ms->corpus_size = st.st_size;
+	if (ms->corpus_size < sizeof(Corpushead) ||
+		(ms->corpus = mmap(0, ms->corpus_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+	{
+		fprintf(stderr, "Exiting: cannot map corpus file %s\n", fileName);
+		exit(1);
+	}
+	close(fd);
+
+	head = (const Corpushead *)ms->corpus;
+	if (memcmp(head->magic, CORPUS_MAGIC, sizeof(head->magic)) != 0 ||
+		head->version != CORPUS_VERSION)
+	{
+		fprintf(stderr, "Exiting: %s is not a corpus file of version %d\n", fileName, CORPUS_VERSION);
+		exit(1);
+	}
+	if (! check_corpushead(head, ms->corpus_size))
+	{
+		fprintf(stderr, "Exiting: corpus file %s is truncated\n", fileName);
+		exit(1);
+	}
+
+	ms->prots.precomputed = (strcmp(head->alphabet, ms->alphabet.name) == 0 &&
+		head->alphabet_size == ms->alphabet.size && head->kword_len == ms->kword_len &&
+		head->score == CORPUS_SCORE);
+
+	/* the protein table points into the mapped file */
+	ms->prots.n_prot = head->n_prot;
+	ms->prots.protein = safe_malloc(head->n_prot * sizeof(ProteinEntry));
+	ms->prots.residues = (char *)ms->corpus + head->residues;
+	ms->prots.n_residue = head->n_residue;
+	ms->prots.allocated = 0;
+	entry = (const Corpusentry *)(ms->corpus + head->entry);
+
+	for (i = 0; i < head->n_prot; ++ i)
+	{
+		if (! check_corpusentry(head, &entry[i], ms->corpus))
+		{
+			fprintf(stderr, "Exiting: corpus file %s is truncated\n", fileName);
+			exit(1);
+		}
+
+		protein = &ms->prots.protein[i];
+		protein->name = (char *)ms->corpus + head->names + entry[i].name;
+		protein->description = protein->name + strlen(protein->name); /* empty */
+		protein->offset = entry[i].seq;
+		protein->seq = &ms->prots.residues[protein->offset];
+		protein->length = entry[i].length;
+
+		if (ms->prots.precomputed)
+		{
+			protein->charCount = (int *)(ms->corpus + head->charcount) + (size_t)i * head->alphabet_size;
+			protein->kwords.kword = (Kword *)(ms->corpus + head->kword) + entry[i].kword;
+			protein->kwords.n_kword = entry[i].n_kword;
+			protein->kwords.n_all = entry[i].n_all;
+			protein->entropy = entry[i].entropy;
+		}
+	}
+}
+
+/*____________________________________________________________________________*/
+void unload_corpus(Minset *ms)
+{
+	munmap(ms->corpus, ms->corpus_size);
+	ms->corpus = 0;
+}
+
@@ -0,0 +1,85 @@
+/*==============================================================================
+corpus.h : binary corpus files of base sets
+(C) 2006-2017 Jens Kleinjung
+(C) 2006-2007 Alessandro Pandini
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+==============================================================================*/
+
+
+#if !defined(CORPUS_H)
+#define CORPUS_H
+
+/*____________________________________________________________________________*/
+/* includes */
+#include <stdint.h>
+
+#include "minset.h"
+
+/*____________________________________________________________________________*/
+/* defines */
+#define CORPUS_MAGIC "MINSETCP" /* first 8 bytes of a corpus file */
+#define CORPUS_VERSION 1 /* version of the corpus file layout */
+
+/* score function of the precomputed entropies */
+#if defined(SUFFIX_TREE_SCORE)
+#define CORPUS_SCORE 2
+#elif defined(COMPRESS_SCORE)
+#define CORPUS_SCORE 1
+#else
+#define CORPUS_SCORE 0
+#endif
+
+/*____________________________________________________________________________*/
+/* structures */
+
+/* A corpus file holds a base set in native byte order: a Corpushead,
+	one Corpusentry per protein, the zero-terminated protein names, the
+	zero-terminated sequences, and the precomputed code character counts
+	('alphabet_size' per protein) and k-word histograms of all proteins.
+	Sections start at 8-byte boundaries at the offsets given in the header. */
+
+typedef struct
+{
+	char magic[8]; /* CORPUS_MAGIC, not terminated */
+	int version; /* CORPUS_VERSION */
+	int n_prot; /* number of proteins */
+	char alphabet[32]; /* alphabet of the precomputed counts */
+	int alphabet_size; /* code array size of the alphabet */
+	int kword_len; /* k-word length of the precomputed histograms */
+	int score; /* CORPUS_SCORE of the precomputed entropies */
+	uint64_t names_size; /* size of the name section */
+	uint64_t n_residue; /* size of the residue section */
+	uint64_t n_kword; /* number of k-word histogram entries */
+	uint64_t entry, names, residues, charcount, kword; /* section offsets */
+} Corpushead;
+
+typedef struct
+{
+	uint64_t name; /* offset of the name in the name section */
+	uint64_t seq; /* offset of the sequence in the residue section */
+	uint64_t kword; /* first entry of the k-word histogram in the k-word section */
+	int length; /* sequence length */
+	int n_kword; /* number of distinct k-words */
+	int n_all; /* total number of k-words */
+	float entropy; /* entropy score */
+} Corpusentry;
+
+/*____________________________________________________________________________*/
+/* prototypes */
+void pack_corpus(Minset *ms, const char *fileName);
+void load_corpus(Minset *ms, const char *fileName);
+void unload_corpus(Minset *ms);
+
+#endif
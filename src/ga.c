@@ -44,6 +44,10 @@ License:
 /*____________________________________________________________________________*/
 /* includes */
 #include "ga.h"
+#include "checkpoint.h"
+#include "corpus.h"
+#include "poolfile.h"
+#include "writer.h"
 #include "gapar.h"
 #include "minset.h"
 #include "parse_args.h"
@@ -66,6 +70,155 @@ void *safe_realloc(void *ptr, size_t size)
     return check_non_null(realloc(ptr, size));
 }
 
+/* 'size' is rounded up to a multiple of 'alignment', as required by 'aligned_alloc' */
+void *safe_aligned_malloc(size_t alignment, size_t size)
+{
+    return check_non_null(aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment));
+}
+
+/*____________________________________________________________________________*/
+/* worker threads: items are claimed one at a time from a shared counter */
+typedef struct
+{
+	void (*work)(void *arg, int i, int tid); /* work function for item 'i' */
+	void *arg; /* argument passed on to the work function */
+	int n; /* number of items */
+	int next; /* next unclaimed item */
+	pthread_mutex_t lock; /* protects 'next' */
+} Parallel;
+
+typedef struct
+{
+	Parallel *par; /* shared work description */
+	int tid; /* thread number, used to address per-thread buffers */
+} Worker;
+
+static void *parallel_worker(void *pw)
+{
+	Worker *worker = (Worker *)pw;
+	Parallel *par = worker->par;
+	int i;
+
+	while (1)
+	{
+		pthread_mutex_lock(&par->lock);
+		i = par->next ++;
+		pthread_mutex_unlock(&par->lock);
+
+		if (i >= par->n)
+			break;
+
+		par->work(par->arg, i, worker->tid);
+	}
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+/* run 'work' on items 0 to n-1 using 'nthreads' threads; returns after all items are done */
+/* the calling thread works as thread 0 */
+void run_parallel(int nthreads, int n, void (*work)(void *arg, int i, int tid), void *arg)
+{
+	int i;
+	Parallel par;
+
+	if (nthreads > n)
+		nthreads = n;
+
+	/* serial execution */
+	if (nthreads <= 1)
+	{
+		for (i = 0; i < n; ++ i)
+			work(arg, i, 0);
+		return;
+	}
+
+	/* parallel execution */
+	pthread_t thread[nthreads];
+	Worker worker[nthreads];
+
+	par.work = work;
+	par.arg = arg;
+	par.n = n;
+	par.next = 0;
+	pthread_mutex_init(&par.lock, 0);
+
+	for (i = 0; i < nthreads; ++ i)
+	{
+		worker[i].par = &par;
+		worker[i].tid = i;
+	}
+
+	for (i = 1; i < nthreads; ++ i)
+		if (pthread_create(&thread[i], 0, parallel_worker, &worker[i]) != 0)
+		{
+			fprintf(stderr, "Exiting: cannot create worker thread %d\n", i);
+			exit(1);
+		}
+
+	parallel_worker(&worker[0]);
+
+	for (i = 1; i < nthreads; ++ i)
+		pthread_join(thread[i], 0);
+
+	pthread_mutex_destroy(&par.lock);
+}
+
+/*____________________________________________________________________________*/
+/* one thread per item, for items that wait for each other */
+typedef struct
+{
+	void (*work)(void *arg, int i, int tid); /* work function for item 'i' */
+	void *arg; /* argument passed on to the work function */
+	int i; /* item */
+} Task;
+
+static void *concurrent_worker(void *pt)
+{
+	Task *task = (Task *)pt;
+
+	task->work(task->arg, task->i, 0);
+
+	return 0;
+}
+
+/* run 'work' on items 0 to n-1 concurrently, one thread per item; */
+/* the calling thread runs item 0 */
+static void run_concurrent(int n, void (*work)(void *arg, int i, int tid), void *arg)
+{
+	int i;
+	pthread_t thread[n];
+	Task task[n];
+
+	for (i = 0; i < n; ++ i)
+	{
+		task[i].work = work;
+		task[i].arg = arg;
+		task[i].i = i;
+	}
+
+	for (i = 1; i < n; ++ i)
+		if (pthread_create(&thread[i], 0, concurrent_worker, &task[i]) != 0)
+		{
+			fprintf(stderr, "Exiting: cannot create island thread %d\n", i);
+			exit(1);
+		}
+
+	concurrent_worker(&task[0]);
+
+	for (i = 1; i < n; ++ i)
+		pthread_join(thread[i], 0);
+}
+
+/*____________________________________________________________________________*/
+/* number of worker threads of each island of each concurrent run */
+int island_threads(Gapar *gaPar)
+{
+	int n_island = gaPar->jobs * gaPar->islands;
+
+	return (gaPar->threads > n_island ? gaPar->threads / n_island : 1);
+}
+
 /*____________________________________________________________________________*/
 /* open file */
 FILE *safe_open(const char *name, const char *mode)
@@ -77,132 +230,254 @@ FILE *safe_open(const char *name, const char *mode)
 }
 
 /*____________________________________________________________________________*/
-/* generate random integer number within range  0 to 'gaPar.uplim' */
-int get_rand(int limit)
+/* generate random integer number within range  0 to 'limit' */
+int get_rand(Rng *rng, int limit)
 {
-    double dranum; /* random number in double format */
-    int iranum; /* random number in integer format */
-    dranum = rand() / (double)INT_MAX; /* generate rand and scale to range 0-1 */
-    iranum = (int)((limit + 1) * dranum); /* scale to integer of range 0-limit */
-    if (iranum == (limit + 1)) -- iranum; /* exclude upper limit */
-    return iranum;
+    return (int)rand_below(rng, (uint32_t)limit + 1);
 }
 
 /*____________________________________________________________________________*/
 /* generate random integer number within range 'low' to 'up' */
-int get_rand_lu(unsigned int low, unsigned int up)
+int get_rand_lu(Rng *rng, unsigned int low, unsigned int up)
 {
     assert(low < up);
 
-    double dranum; /* random number in double format */
-    int iranum; /* random number in integer format */
-    dranum = rand() / (double)INT_MAX; /* generate rand and scale to range 0-1 */
-    iranum = (int)(((up - low + 1) * dranum) + low); /* scale to range [low,up] */
-    if (iranum == (up + 1)) -- iranum; /* exclude upper limit */
-    return iranum;
+    return (int)(low + rand_below(rng, up - low + 1));
 }
 
 /*____________________________________________________________________________*/
-/* fitness comparison routine used by 'qsort'  */
-int cmp_fitness(const void *pp1, const void *pp2)
+/* random number stream of genome slot 'ix' of 'island' in generation 'l' */
+/* of repeat 'j' and jackknife fraction 'k'; generation -1 is the initial pool */
+static void genome_rng(Rng *rng, Gapar *gaPar, int j, int k, int l, int island, int ix)
 {
-    Pool *p1 = (Pool*)pp1;
-    Pool *p2 = (Pool*)pp2;
+	seed_rng(rng, (uint64_t)gaPar->seed, j, k, l, island * gaPar->popsize + ix);
+}
 
-#ifdef MINIMIZE
-    return (p1->fitness > p2->fitness ? -1 : 1); /* MINIMIZE */
+/*____________________________________________________________________________*/
+/* fitness comparison routines used by 'qsort' and 'select_ranks' */
+/* ties are broken by pool index, so that the order is deterministic */
+static int cmp_rank_max(const void *pr1, const void *pr2)
+{
+    Rank *r1 = (Rank *)pr1;
+    Rank *r2 = (Rank *)pr2;
+
+    if (r1->fitness != r2->fitness)
+        return (r1->fitness > r2->fitness ? -1 : 1); /* MAXIMIZE */
+    return (r1->ix > r2->ix) - (r1->ix < r2->ix);
+}
+
+static int cmp_rank_min(const void *pr1, const void *pr2)
+{
+    Rank *r1 = (Rank *)pr1;
+    Rank *r2 = (Rank *)pr2;
+
+    if (r1->fitness != r2->fitness)
+        return (r1->fitness < r2->fitness ? -1 : 1); /* MINIMIZE */
+    return (r1->ix > r2->ix) - (r1->ix < r2->ix);
+}
+
+/*____________________________________________________________________________*/
+/* partition 'rank' such that its 'n' first elements are the 'n' top ranks */
+/* (quickselect with median-of-three pivot) */
+static void select_ranks(Rank *rank, int len, int n, int (*cmp)(const void *, const void *))
+{
+	int lo = 0, hi = len - 1;
+	int i, j, mid;
+	Rank pivot, swap;
+
+	while (hi > lo)
+	{
+		/* median of first, middle and last element as pivot */
+		mid = lo + (hi - lo) / 2;
+		if (cmp(&rank[mid], &rank[lo]) < 0)
+			swap = rank[mid], rank[mid] = rank[lo], rank[lo] = swap;
+		if (cmp(&rank[hi], &rank[lo]) < 0)
+			swap = rank[hi], rank[hi] = rank[lo], rank[lo] = swap;
+		if (cmp(&rank[hi], &rank[mid]) < 0)
+			swap = rank[hi], rank[hi] = rank[mid], rank[mid] = swap;
+		pivot = rank[mid];
+
+		/* Hoare partition */
+		for (i = lo, j = hi; i <= j; )
+		{
+			while (cmp(&rank[i], &pivot) < 0)
+				++ i;
+			while (cmp(&pivot, &rank[j]) < 0)
+				-- j;
+			if (i <= j)
+			{
+				swap = rank[i], rank[i] = rank[j], rank[j] = swap;
+				++ i;
+				-- j;
+			}
+		}
+
+		/* continue in the part that contains the n-th element */
+		if (n - 1 <= j)
+			hi = j;
+		else if (n - 1 >= i)
+			lo = i;
+		else
+			break;
+	}
+}
+
+/*____________________________________________________________________________*/
+/* set all genomes and fitness values to 0 */
+void clear_pool(Pool *pool)
+{
+	int i;
+
+#ifdef BIT
+	memset(pool->bitgenome, 0, (size_t)pool->size * pool->stride * sizeof(uint64_t));
 #else
-    return (p1->fitness < p2->fitness ? -1 : 1);  /* MAXIMIZE */
+	memset(pool->genome, 0, (size_t)pool->size * pool->stride * sizeof(int));
 #endif
+	for (i = 0; i < pool->size; ++ i)
+	{
+		pool->order[i] = i;
+		pool->fitness[i] = 0.;
+	}
 }
 
 /*____________________________________________________________________________*/
-/* sort pool by fitness */
-void sort_fitness(Pool *pool, Gapar *gaPar)
+/* allocate a pool of 'size' genomes, all set to 0, in one block of aligned rows */
+void init_pool(Pool *pool, Gapar *gaPar, int size)
 {
-    qsort(&pool[0], gaPar->popsize, sizeof(Pool), cmp_fitness);
+#ifdef BIT
+	size_t bytes = BITWORDS(gaPar->genenum) * sizeof(uint64_t);
+#else
+	size_t bytes = gaPar->genenum * sizeof(int);
+#endif
+
+	/* pad rows to whole cache lines */
+	bytes = (bytes + POOL_ALIGN - 1) / POOL_ALIGN * POOL_ALIGN;
+#ifdef BIT
+	pool->stride = bytes / sizeof(uint64_t);
+	pool->bitgenome = safe_aligned_malloc(POOL_ALIGN, size * bytes); /* bitgene pool */
+#else
+	pool->stride = bytes / sizeof(int);
+	pool->genome = safe_aligned_malloc(POOL_ALIGN, size * bytes); /* gene pool */
+#endif
+	pool->order = safe_malloc(size * sizeof(int));
+	pool->fitness = safe_malloc(size * sizeof(float));
+	pool->rank = safe_malloc(size * sizeof(Rank));
+	pool->sorted = safe_malloc(size * sizeof(int));
+	pool->size = size;
+
+	clear_pool(pool);
 }
 
 /*____________________________________________________________________________*/
-/* bitfield genome: set gene state to either 0 or 1, depending on passed integer 'i' */
+void free_pool(Pool *pool)
+{
 #ifdef BIT
-void set_bitgene(Bitgene *bitgen, int i) 
+	free(pool->bitgenome);
+#else
+	free(pool->genome);
+#endif
+	free(pool->order);
+	free(pool->fitness);
+	free(pool->rank);
+	free(pool->sorted);
+}
+
+/*____________________________________________________________________________*/
+/* move the 'gaPar.fitmate' fittest genomes, sorted by fitness, to the top */
+/* of the pool; the order of the other genomes is not defined */
+/* only row indices and fitness values are moved, not the genomes */
+void sort_fitness(Pool *pool, Gapar *gaPar)
 {
-	bitgen->state = i > 0 ? 1 : 0;
+	int i;
+	int (*cmp)(const void *, const void *) = gaPar->minimize ? cmp_rank_min : cmp_rank_max;
+	Rank *rank = pool->rank;
+	int *order = pool->sorted;
+
+	for (i = 0; i < gaPar->popsize; ++ i)
+	{
+		rank[i].fitness = pool->fitness[i];
+		rank[i].ix = i;
+	}
+
+	/* select the fittest genomes, then sort only these */
+	select_ranks(rank, gaPar->popsize, gaPar->fitmate, cmp);
+	qsort(rank, gaPar->fitmate, sizeof(Rank), cmp);
+
+	for (i = 0; i < gaPar->popsize; ++ i)
+	{
+		order[i] = pool->order[rank[i].ix];
+		pool->fitness[i] = rank[i].fitness;
+	}
+	memcpy(pool->order, order, gaPar->popsize * sizeof(int));
 }
-#endif
 
 /*____________________________________________________________________________*/
-/* bitfield genome: return integer 0 or 1, depending on gene bit 'state' */
+/* bitgenome: mask of the used bits in the last genome word */
 #ifdef BIT
-int get_bitgene(Bitgene *bitgen) 
+static uint64_t last_bitword_mask(Gapar *gaPar)
 {
-	return (int)bitgen->state > 0 ? 1 : 0;
+	int used = gaPar->genenum % BITWORD;
+
+	return (used == 0 ? ~(uint64_t)0 : ((uint64_t)1 << used) - 1);
 }
 #endif
 
 /*____________________________________________________________________________*/
 /* vary value */
-int vary_value(int val, Gapar *gaPar)
+int vary_value(Rng *rng, int val, Gapar *gaPar)
 {
     int newval; /* new value */
     int mp; /* minus/plus */
 
-    mp = get_rand(2);
+    mp = get_rand(rng, 2);
 
     if (mp == 1)
-        while ((newval = val - get_rand(gaPar->maxvar)) < gaPar->lowlim);
+        while ((newval = val - get_rand(rng, gaPar->maxvar)) < gaPar->lowlim);
     else
-        while ((newval = val + get_rand(gaPar->maxvar)) > gaPar->uplim);
+        while ((newval = val + get_rand(rng, gaPar->maxvar)) > gaPar->uplim);
     return newval;
 }
 
 /*____________________________________________________________________________*/
-/* initialise random pool and fitness*/
-static void init_random_pool(Pool *pool, Gapar *gaPar)
+/* initialise random genome 'ix' and fitness */
+static void init_random_genome(Pool *pool, Gapar *gaPar, int ix, Rng *rng)
 {
-    unsigned int i, j;
+    unsigned int j;
 
-    for (i = 0; i < gaPar->popsize; ++ i) /* genomes */
-    {
-        for (j = 0; j < gaPar->genenum; ++ j) /* genes */
-		{
 #ifdef BIT
-            set_bitgene(&pool[i].bitgenome[j], get_rand(gaPar->uplim)); /* random value */
+    for (j = 0; j < BITWORDS(gaPar->genenum); ++ j) /* 64 genes at a time */
+        pool_bitgenome(pool, ix)[j] = rand_bits(rng); /* random values */
+    pool_bitgenome(pool, ix)[j - 1] &= last_bitword_mask(gaPar);
 #else
-            pool[i].genome[j] = get_rand(gaPar->uplim); /* random value */
+    for (j = 0; j < gaPar->genenum; ++ j) /* genes */
+        pool_genome(pool, ix)[j] = get_rand(rng, gaPar->uplim); /* random value */
 #endif
-		}
 
-        pool[i].fitness = 0; /* initialise fitness */
-    }
+    pool->fitness[ix] = 0; /* initialise fitness */
 }
 
 /*____________________________________________________________________________*/
-/* initialise seeded pool and fitness */
-void init_seeded_pool(Pool *pool, Gapar *gaPar)
+/* initialise seeded genome 'ix' and fitness */
+static void init_seeded_genome(Pool *pool, Gapar *gaPar, int ix, Rng *rng)
 {
-    unsigned int i, j;
+    unsigned int j;
 
-    for (i = 0; i < gaPar->popsize; ++ i) /* genomes */
-    {
-		/* assign defined value to each gene */
-		/*
-		pool[i].genome[0] = 4;
-		*/
+	/* assign defined value to each gene */
+	/*
+	pool_genome(pool, ix)[0] = 4;
+	*/
+
+	pool->fitness[ix] = 0; /* initialise fitness */
 
-		pool[i].fitness = 0; /* initialise fitness */
-    }
-    
     /* vary values, not first genome */
-    for (i = 1; i < gaPar->popsize; ++ i)
+    if (ix > 0)
     {
 		for (j = 0; j < gaPar->genenum; ++ j)
 		{
 #ifdef BIT
-			set_bitgene(&pool[i].bitgenome[j], vary_value(get_bitgene(&pool[i].bitgenome[j]), gaPar));
+			set_bitgene(pool_bitgenome(pool, ix), j, vary_value(rng, get_bitgene(pool_bitgenome(pool, ix), j), gaPar));
 #else
-			pool[i].genome[j] = vary_value(pool[i].genome[j], gaPar);
+			pool_genome(pool, ix)[j] = vary_value(rng, pool_genome(pool, ix)[j], gaPar);
 #endif
 		}
     }
@@ -210,28 +485,35 @@ void init_seeded_pool(Pool *pool, Gapar *gaPar)
 
 /*____________________________________________________________________________*/
 /* equilibrium: calc average parameter values in fittest genomes */
+/* column sums are accumulated genome by genome, along the rows of the pool */
 void equilibrium(Pool *pool, Gapar *gaPar, int *average)
 {
     unsigned int i, j;
+#ifdef BIT
+    uint64_t word;
+#endif
 
-    for (j = 0; j < gaPar->genenum; ++ j)
+    memset(average, 0, gaPar->genenum * sizeof(int));
+
+    for (i = 0; i < gaPar->fitmate; ++ i) /* sum up over the fittest genomes */
     {
-		average[j] = 0;
-		for (i = 0; i < gaPar->fitmate; ++ i) /* sum up over the fittest genomes */
-		{
 #ifdef BIT
-			average[j] += get_bitgene(&pool[i].bitgenome[j]);
+		for (j = 0; j < BITWORDS(gaPar->genenum); ++ j)
+			for (word = pool_bitgenome(pool, i)[j]; word != 0; word &= word - 1)
+				++ average[j * BITWORD + __builtin_ctzll(word)];
 #else
-			average[j] += pool[i].genome[j];
+		for (j = 0; j < gaPar->genenum; ++ j)
+			average[j] += pool_genome(pool, i)[j];
 #endif
-		}
-		average[j]  = (int)(average[j]/gaPar->fitmate); /* normalize */
     }
+
+    for (j = 0; j < gaPar->genenum; ++ j)
+		average[j] = (int)(average[j]/gaPar->fitmate); /* normalize */
 }
 
 /*____________________________________________________________________________*/
-/* breed_equilibrium: generate equilibrium genomes */ 
-void breed_equilibrium(Pool *pool, Gapar *gaPar, int *average, int ix)
+/* breed_equilibrium: generate equilibrium genome by variation of the average values */ 
+void breed_equilibrium(Pool *pool, Gapar *gaPar, int *average, int ix, Rng *rng)
 {
     unsigned int j;
 
@@ -240,12 +522,12 @@ void breed_equilibrium(Pool *pool, Gapar *gaPar, int *average, int ix)
     for (j = 0; j < gaPar->genenum; ++ j)
 	{
 #ifdef BIT
-		set_bitgene(&pool[ix].bitgenome[j], vary_value(get_bitgene(&pool[ix].bitgenome[j]), gaPar->maxvar));
+		set_bitgene(pool_bitgenome(pool, ix), j, vary_value(rng, average[j], gaPar));
 #else
-pool[ix].genome[j] = vary_value(pool[ix].genome[j], gaPar);
+		pool_genome(pool, ix)[j] = vary_value(rng, average[j], gaPar);
 #endif
 	}
-    pool[ix].fitness = 0; /* initialise fitness */
+    pool->fitness[ix] = 0; /* initialise fitness */
 }
 
 /*____________________________________________________________________________*/
@@ -255,147 +537,588 @@ int gene_sum(Pool *pool, Gapar *gaPar, int ix)
 	unsigned int gsum = 0;
     unsigned int i;
 
-    for(i = 0; i < gaPar->genenum; ++ i)
-	{
 #ifdef BIT
-		gsum += get_bitgene(&pool[ix].bitgenome[i]);
+    for(i = 0; i < BITWORDS(gaPar->genenum); ++ i)
+		gsum += __builtin_popcountll(pool_bitgenome(pool, ix)[i]);
 #else
-        gsum += pool[ix].genome[i];
+    for(i = 0; i < gaPar->genenum; ++ i)
+        gsum += pool_genome(pool, ix)[i];
 #endif
-	}
 
 	return gsum;
 }
 
 /*____________________________________________________________________________*/
-/* constrain individual genome to specified maximal gene number */
-void constrain_genome(Pool *pool, Gapar *gaPar, int ix, int maxgenes)
+/* set genes 'index[0]' to 'index[n-1]' of genome 'ix' to 'state' */
+static void set_genes(Pool *pool, int ix, int *index, int n, int state)
 {
-    unsigned int j;
+	int i;
 
-	 /* check that total number of selected genes does not exceed 'maxgenes' */
-    while(gene_sum(pool, gaPar, ix) > maxgenes)
+	for (i = 0; i < n; ++ i)
+#ifdef BIT
+		set_bitgene(pool_bitgenome(pool, ix), index[i], state);
+#else
+		pool_genome(pool, ix)[index[i]] = state;
+#endif
+}
+
+/*____________________________________________________________________________*/
+/* move 'n' randomly chosen elements of 'index[0]' to 'index[len-1]' to the front */
+/* (partial Fisher-Yates shuffle) */
+static void choose_random(int *index, int len, int n, Rng *rng)
+{
+	int i, j, swap;
+
+	for (i = 0; i < n; ++ i)
 	{
-        /* deselect a random protein*/
+		j = i + get_rand(rng, len - i - 1);
+		swap = index[i];
+		index[i] = index[j];
+		index[j] = swap;
+	}
+}
+
+/*____________________________________________________________________________*/
+/* constrain individual genome to specified maximal gene number */
+/* excess genes are deselected at random; with 'gaPar.fill', missing genes */
+/* are selected at random, so that exactly 'maxgenes' genes are selected; */
+/* 'index' is a workspace of 'gaPar.genenum' genes */
+void constrain_genome(Pool *pool, Gapar *gaPar, int ix, int maxgenes, Rng *rng, int *index)
+{
+	int j;
+	int n_on = 0, n_off = 0; /* number of selected and unselected genes */
+#ifdef BIT
+	uint64_t word;
+#endif
+
+	/* 'index': selected genes at the front, unselected genes at the back */
 #ifdef BIT
-        do {
-			j = (int) (rand()/(double)INT_MAX * gaPar->genenum);
-        } while(get_bitgene(&pool[ix].bitgenome[j]) == 0);
-        set_bitgene(&pool[ix].bitgenome[j], 0); 
+	for (j = 0; j < BITWORDS(gaPar->genenum); ++ j)
+		for (word = pool_bitgenome(pool, ix)[j]; word != 0; word &= word - 1)
+			index[n_on ++] = j * BITWORD + __builtin_ctzll(word);
+	if (gaPar->fill && n_on < maxgenes)
+		for (j = 0; j < gaPar->genenum; ++ j)
+			if (! get_bitgene(pool_bitgenome(pool, ix), j))
+				index[gaPar->genenum - ++ n_off] = j;
 #else
-        do {
-			j = (int) (rand()/(double)INT_MAX * gaPar->genenum);
-        } while(pool[ix].genome[j] == 0);
-        pool[ix].genome[j] = 0; 
+	for (j = 0; j < gaPar->genenum; ++ j)
+	{
+		if (pool_genome(pool, ix)[j] != 0)
+			index[n_on ++] = j;
+		else
+			index[gaPar->genenum - ++ n_off] = j;
+	}
 #endif
-    }
+
+	if (n_on > maxgenes)
+	{
+		/* deselect random proteins */
+		choose_random(&index[0], n_on, n_on - maxgenes, rng);
+		set_genes(pool, ix, &index[0], n_on - maxgenes, 0);
+	}
+	else if (gaPar->fill && n_on < maxgenes)
+	{
+		/* select random proteins */
+		choose_random(&index[gaPar->genenum - n_off], n_off, maxgenes - n_on, rng);
+		set_genes(pool, ix, &index[gaPar->genenum - n_off], maxgenes - n_on, 1);
+	}
 }
 
 /*____________________________________________________________________________*/
 /* breed_crossover: crossover between gaPar.fitmate pairs and create genome 'ix' */ 
-void breed_crossover(Pool *pool, Gapar *gaPar, int iy)
+/* bitgenome: every genome word is a uniform crossover of a pair of parents */
+void breed_crossover(Pool *pool, Gapar *gaPar, int iy, Rng *rng)
 {
-    int ia, ib, j, yn;
+    int ia, ib, j;
+#ifdef BIT
+    uint64_t mask; /* genes taken from the crossover parent */
+#else
+    int yn;
+#endif
 
     ia = -1;
     ib = -1;
+#ifdef BIT
+    for (j = 0; j < BITWORDS(gaPar->genenum); ++ j)
+#else
     for (j = 0; j < gaPar->genenum; ++ j)
+#endif
     {
-		ia = get_rand(gaPar->fitmate); /* principal parent (1)*/
+		ia = get_rand(rng, gaPar->fitmate - 1); /* principal parent (1)*/
 
 		do
-			ib = get_rand(gaPar->fitmate); /* crossover parent (2) */
-		while (ib == ia);
+			ib = get_rand(rng, gaPar->fitmate - 1); /* crossover parent (2) */
+		while (ib == ia && gaPar->fitmate > 1);
 
-		yn = get_rand(2); /* choose crossover yes/no */
 #ifdef BIT
-		if (yn == 1)
-			set_bitgene(&pool[iy].bitgenome[j], get_bitgene(&pool[ib].bitgenome[j]));
-		else
-			set_bitgene(&pool[iy].bitgenome[j], get_bitgene(&pool[ia].bitgenome[j]));
+		mask = rand_bits(rng); /* choose crossover yes/no for each gene */
+		pool_bitgenome(pool, iy)[j] = (pool_bitgenome(pool, ia)[j] & ~mask) | (pool_bitgenome(pool, ib)[j] & mask);
 #else
+		yn = get_rand(rng, 2); /* choose crossover yes/no */
 		if (yn == 1)
-			pool[iy].genome[j] = pool[ib].genome[j];
+			pool_genome(pool, iy)[j] = pool_genome(pool, ib)[j];
 		else
-			pool[iy].genome[j] = pool[ia].genome[j];
+			pool_genome(pool, iy)[j] = pool_genome(pool, ia)[j];
 #endif
     }
 
-    pool[iy].fitness = 0; /* initialise fitness */
+    pool->fitness[iy] = 0; /* initialise fitness */
 }
 
 /*____________________________________________________________________________*/
-/* mem_fitness: get fitness from identical genome that has already been calculated */
-int mem_fitness(Pool *pool, Gapar *gaPar, int ix)
+/* generation of genomes, shared by the worker threads */
+typedef struct
 {
-    unsigned int i, j;
-    unsigned int id;
+	Pool *pool; /* gene pool */
+	Gapar *gaPar; /* GA parameters */
+	int *average; /* equilibrium values of the fittest genomes */
+	int maxgenes; /* maximal number of selected genes, 0 for no constraint */
+	int *genes; /* constraint workspace, 'gaPar.genenum' genes per worker thread */
+	int j, k, l; /* repeat, jackknife fraction, generation (-1: initial pool) */
+	int island; /* island of the pool */
+	int ix; /* first genome slot */
+} Breeding;
+
+/* generate genome in slot 'ix' + 'i' from its own random number stream */
+static void breed_genome(void *pb, int i, int tid)
+{
+	Breeding *br = (Breeding *)pb;
+	Gapar *gaPar = br->gaPar;
+	int iy = br->ix + i;
+	Rng rng;
 
-    for (i = 0; i < ix; ++ i)
-    {
-		id = 1;
+	genome_rng(&rng, gaPar, br->j, br->k, br->l, br->island, iy);
 
-		/* test whether any gene of 'i' and 'ix' differs */
-		for (j = 0; j < gaPar->genenum; ++ j)
-		{
+	if (br->l < 0)
+	{
+		if (gaPar->random)
+			init_random_genome(br->pool, gaPar, iy, &rng); /* random pool */
+		if (gaPar->seeded)
+			init_seeded_genome(br->pool, gaPar, iy, &rng); /* seeded pool */
+	}
+	else
+	{
+		if (gaPar->crossover)
+			breed_crossover(br->pool, gaPar, iy, &rng);
+		if (gaPar->equilibrium)
+			breed_equilibrium(br->pool, gaPar, br->average, iy, &rng);
+	}
+
+	/* if required, constrain the size the newly generated genome */
+	if (br->maxgenes > 0)
+		constrain_genome(br->pool, gaPar, iy, br->maxgenes, &rng,
+			&br->genes[tid * gaPar->genenum]);
+}
+
+/*____________________________________________________________________________*/
+/* generate genomes 'ix' to 'gaPar.popsize'-1 of generation 'l' on the worker threads */
+/* of 'island'; children are bred from the fittest genomes 0 to 'gaPar.fitmate'-1, */
+/* which are read-only here, and written to disjoint slots */
+void breed_pool(Pool *pool, Gapar *gaPar, int *average, int maxgenes, int *genes,
+	int j, int k, int l, int island, int ix)
+{
+	Breeding br;
+
+	br.pool = pool;
+	br.gaPar = gaPar;
+	br.average = average;
+	br.maxgenes = maxgenes;
+	br.genes = genes;
+	br.j = j;
+	br.k = k;
+	br.l = l;
+	br.island = island;
+	br.ix = ix;
+
+	/* equilibrium values are the same for all children */
+	if (l >= 0 && gaPar->equilibrium)
+		equilibrium(pool, gaPar, average);
+
+	run_parallel(island_threads(gaPar), gaPar->popsize - ix, breed_genome, &br);
+}
+
+/*____________________________________________________________________________*/
+/* fitness memo: slot states */
+#define MEMO_EMPTY 0 /* free slot */
+#define MEMO_PENDING 1 /* genome under evaluation, fitness not yet known */
+#define MEMO_KNOWN 2 /* genome with known fitness */
+
+/*____________________________________________________________________________*/
+/* allocate memo for at least 'MEMO' * 'gaPar.popsize' genomes */
+void init_memo(Memo *memo, Gapar *gaPar)
+{
 #ifdef BIT
-			if (get_bitgene(&pool[i].bitgenome[j]) != get_bitgene(&pool[ix].bitgenome[j]))
-				id = 0;
+	memo->bits = 1;
+	memo->n_word = BITWORDS(gaPar->genenum);
 #else
-			if (pool[i].genome[j] != pool[ix].genome[j])
-				id = 0;
+	memo->bits = (gaPar->uplim - gaPar->lowlim == 1);
+	if (memo->bits)
+		memo->n_word = (gaPar->genenum + 63) / 64;
+	else
+		memo->n_word = (gaPar->genenum * sizeof(int) + 7) / 8;
 #endif
+
+	for (memo->size = 1; memo->size < MEMO * gaPar->popsize; memo->size *= 2)
+		;
+
+	memo->key = safe_malloc(memo->size * memo->n_word * sizeof(uint64_t));
+	memo->hash = safe_malloc(memo->size * 2 * sizeof(uint64_t));
+	memo->fitness = safe_malloc(memo->size * sizeof(float));
+	memo->state = safe_malloc(memo->size * sizeof(char));
+	memo->scratch = safe_malloc(memo->n_word * sizeof(uint64_t));
+
+	memo->hit = 0;
+	memo->miss = 0;
+	clear_memo(memo);
+}
+
+/*____________________________________________________________________________*/
+/* forget all genomes, e.g. when the fitness function changes */
+void clear_memo(Memo *memo)
+{
+	memset(memo->state, MEMO_EMPTY, memo->size * sizeof(char));
+}
+
+/*____________________________________________________________________________*/
+void free_memo(Memo *memo)
+{
+	free(memo->key);
+	free(memo->hash);
+	free(memo->fitness);
+	free(memo->state);
+	free(memo->scratch);
+}
+
+/*____________________________________________________________________________*/
+/* pack genome 'ix' into 'memo.scratch' and hash it */
+static void hash_genome(Memo *memo, Pool *pool, Gapar *gaPar, int ix, uint64_t *hash)
+{
+	int i;
+	uint64_t w;
+
+#ifdef BIT
+	memcpy(memo->scratch, pool_bitgenome(pool, ix), memo->n_word * sizeof(uint64_t));
+#else
+	memset(memo->scratch, 0, memo->n_word * sizeof(uint64_t));
+	if (memo->bits)
+	{
+		for (i = 0; i < gaPar->genenum; ++ i)
+			if (pool_genome(pool, ix)[i] != gaPar->lowlim)
+				memo->scratch[i / 64] |= (uint64_t)1 << (i % 64);
+	}
+	else
+		memcpy(memo->scratch, pool_genome(pool, ix), gaPar->genenum * sizeof(int));
+#endif
+
+	/* two independent 64-bit multiply-xorshift hashes */
+	hash[0] = 0x9E3779B97F4A7C15ULL;
+	hash[1] = 0xC2B2AE3D27D4EB4FULL;
+	for (i = 0; i < memo->n_word; ++ i)
+	{
+		w = memo->scratch[i];
+		hash[0] = (hash[0] ^ w) * 0xFF51AFD7ED558CCDULL;
+		hash[0] ^= hash[0] >> 32;
+		hash[1] = (hash[1] ^ (w + i)) * 0xC4CEB9FE1A85EC53ULL;
+		hash[1] ^= hash[1] >> 29;
+	}
+}
+
+/*____________________________________________________________________________*/
+/* memo_fitness: get fitness from identical genome that has already been calculated */
+/* returns MEMO_KNOWN if the fitness of genome 'ix' was found, */
+/* MEMO_PENDING if an identical genome is still being evaluated and MEMO_EMPTY otherwise; */
+/* 'slot' returns the memo slot of the genome, or -1 if it could not be stored */
+int memo_fitness(Memo *memo, Pool *pool, Gapar *gaPar, int ix, int *slot)
+{
+	int i, s;
+	int evict = -1; /* known genome that can be replaced */
+	uint64_t hash[2];
+
+	hash_genome(memo, pool, gaPar, ix, &hash[0]);
+
+	for (i = 0, *slot = -1; i < MEMO_PROBE; ++ i)
+	{
+		s = (int)((hash[0] + i) & (memo->size - 1));
+
+		if (memo->state[s] == MEMO_EMPTY)
+		{
+			*slot = s;
+			break;
 		}
-		/* if identical and already fitnessed: copy fitness */
-		if ((id == 1) && (pool[i].fitness > 0))
+
+		/* verify hash collisions on the packed genome */
+		if (memo->hash[2 * s] == hash[0] && memo->hash[2 * s + 1] == hash[1] &&
+			memcmp(&memo->key[s * memo->n_word], memo->scratch, memo->n_word * sizeof(uint64_t)) == 0)
 		{
-			pool[ix].fitness = pool[i].fitness;
-			return 1;
-		} 
-    }
+			*slot = s;
+			++ memo->hit;
+			if (memo->state[s] == MEMO_KNOWN)
+				pool->fitness[ix] = memo->fitness[s];
+			return memo->state[s];
+		}
 
-    return 0;
+		if (evict < 0 && memo->state[s] == MEMO_KNOWN)
+			evict = s;
+	}
+
+	++ memo->miss;
+
+	/* store the genome, to be completed after evaluation */
+	if (*slot < 0)
+		*slot = evict;
+	if (*slot >= 0)
+	{
+		memcpy(&memo->key[*slot * memo->n_word], memo->scratch, memo->n_word * sizeof(uint64_t));
+		memo->hash[2 * *slot] = hash[0];
+		memo->hash[2 * *slot + 1] = hash[1];
+		memo->state[*slot] = MEMO_PENDING;
+	}
+
+	return MEMO_EMPTY;
 }
 
 /*____________________________________________________________________________*/
 /* check_convergence: all genomes identical */
 int check_convergence(Pool *pool, Gapar *gaPar)
 {
-    unsigned int i, j;
+    unsigned int i;
 
     for (i = 1; i < gaPar->popsize; ++ i)
-		for (j = 0; j < gaPar->genenum; ++ j)
-			if (pool[i].genome[j] != pool[i-1].genome[j])
-				return 1;
+#ifdef BIT
+		if (memcmp(pool_bitgenome(pool, i), pool_bitgenome(pool, i-1), BITWORDS(gaPar->genenum) * sizeof(uint64_t)) != 0)
+#else
+		if (memcmp(pool_genome(pool, i), pool_genome(pool, i-1), gaPar->genenum * sizeof(int)) != 0)
+#endif
+			return 1;
 
     return 0;
 }
 
 /*____________________________________________________________________________*/
-/* print pool in binary format */
-void print_pool_bin(Pool *pool, Gapar *gaPar, FILE *outfile)
+/* fitness evaluation of one generation, shared by the worker threads */
+typedef struct
 {
-    unsigned int i, j;
-    char ci;
+	Pool *pool; /* gene pool */
+	Gapar *gaPar; /* GA parameters */
+	Minset *ms; /* application data, read-only during evaluation */
+	int j, k, l; /* repeat, jackknife fraction, generation */
+	int island; /* island of the pool */
+	int *todo; /* indices of genomes that need evaluation */
+} Evaluation;
+
+static void evaluate_genome(void *pe, int i, int tid)
+{
+	Evaluation *ev = (Evaluation *)pe;
+	int ix = ev->todo[i];
 
-    for (i = 0; i < gaPar->popsize; ++ i)
-    {
-        fwrite(&i, sizeof(int), 1, outfile);
+	/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+	/* run application */
+	ev->pool->fitness[ix] = run_minset(ev->pool, ev->gaPar, ev->ms, ev->j, ev->k, ev->l, ix, ev->island, tid);
+	/*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<*/
+}
 
-        for (j = 0; j < gaPar->genenum; ++ j)
-        {
+/*____________________________________________________________________________*/
+/* evaluate fitness of genomes 'ix' to 'gaPar.popsize'-1 on the worker threads of 'island' */
+void evaluate_pool(Pool *pool, Gapar *gaPar, Minset *ms, Memo *memo, int j, int k, int l, int island, int ix)
+{
+	Evaluation ev;
+	int i;
+	int ntodo = 0, ncopy = 0;
+	int *todoslot = safe_malloc(gaPar->popsize * sizeof(int)); /* memo slots of evaluated genomes */
+	int *copy = safe_malloc(gaPar->popsize * sizeof(int)); /* genomes identical to evaluated ones */
+	int *copyslot = safe_malloc(gaPar->popsize * sizeof(int)); /* memo slots of copied genomes */
+	int slot;
+
+	/* resolve genomes found in the memo first, */
+	/* then evaluate the remaining genomes on the worker threads */
+	ev.todo = safe_malloc(gaPar->popsize * sizeof(int));
+	for ( ; ix < gaPar->popsize; ++ ix)
+	{
+		switch (memo_fitness(memo, pool, gaPar, ix, &slot))
+		{
+			case MEMO_EMPTY:
+				todoslot[ntodo] = slot;
+				ev.todo[ntodo ++] = ix;
+				break;
+			case MEMO_PENDING:
+				copyslot[ncopy] = slot;
+				copy[ncopy ++] = ix;
+				break;
+		}
+	}
+
+	ev.pool = pool;
+	ev.gaPar = gaPar;
+	ev.ms = ms;
+	ev.j = j;
+	ev.k = k;
+	ev.l = l;
+	ev.island = island;
+
+	run_parallel(island_threads(gaPar), ntodo, evaluate_genome, &ev);
+
+	/* complete the memo and copy fitness to identical genomes */
+	for (i = 0; i < ntodo; ++ i)
+	{
+		if (todoslot[i] >= 0)
+		{
+			memo->fitness[todoslot[i]] = pool->fitness[ev.todo[i]];
+			memo->state[todoslot[i]] = MEMO_KNOWN;
+		}
+	}
+	for (i = 0; i < ncopy; ++ i)
+		pool->fitness[copy[i]] = memo->fitness[copyslot[i]];
+
+	free(ev.todo);
+	free(todoslot);
+	free(copy);
+	free(copyslot);
+}
+
+/*____________________________________________________________________________*/
+/* binary pool file (format in poolfile.h): frames are written with 'pwrite' */
+/* at offsets given by their index, so that the order of writing does not */
+/* matter and a resumed run keeps the frames written before its checkpoint */
+
+/* open pool file 'fileName' of repeat 'j' and jackknife fraction 'k' */
+static int open_pool_file(const char *fileName, Poolhead *head, Gapar *gaPar, int j, int k)
+{
+	int fd = open(fileName, O_WRONLY | O_CREAT, 0644);
+
+	if (fd < 0)
+	{
+		fprintf(stderr, "Exiting: cannot open pool file %s\n", fileName);
+		exit(1);
+	}
+
+	memset(head, 0, sizeof(Poolhead));
+	memcpy(head->magic, POOLFILE_MAGIC, sizeof(head->magic));
+	head->version = POOLFILE_VERSION;
+	head->genenum = gaPar->genenum;
+	head->n_word = BITWORDS(gaPar->genenum);
+	head->popsize = gaPar->popsize;
+	head->fitmate = gaPar->fitmate;
+	head->islands = gaPar->islands;
+	head->frames = gaPar->frames;
+	head->minimize = gaPar->minimize;
+	head->seed = gaPar->seed;
+	head->j = j;
+	head->k = k;
+
+	return fd;
+}
+
+/* frame snapshot, followed by the frame data */
+typedef struct
+{
+	int fd; /* pool file */
+	int i; /* frame number */
+	size_t offset; /* file offset of the frame */
+	size_t size; /* size of the frame */
+} Framejob;
+
+static void write_frame_job(void *data)
+{
+	Framejob *fj = (Framejob *)data;
+
+	if (pwrite(fj->fd, fj + 1, fj->size, fj->offset) != (ssize_t)fj->size)
+	{
+		fprintf(stderr, "Exiting: cannot write frame %d of pool file\n", fj->i);
+		exit(1);
+	}
+}
+
+/* queue the 'n_genome' fittest genomes of 'pool' as frame 'i', fittest first; */
+/* genomes after the 'fitmate' ranked ones are sorted here; */
+/* return the file offset after the frame */
+static size_t write_pool_frame(Writer *writer, int fd, Poolhead *head, Pool *pool, int n_genome,
+	int i, int l, int island, int final)
+{
+	int ix;
+	size_t size = poolframe_size(head, n_genome);
+	size_t offset = poolframe_offset(head, i);
+	Framejob *fj = safe_malloc(sizeof(Framejob) + size);
+	unsigned char *buffer = (unsigned char *)(fj + 1);
+	Poolframe *frame = (Poolframe *)buffer;
+	uint64_t *genome;
+	float *fitness = (float *)(buffer + sizeof(Poolframe));
+	Rank *rank = pool->rank;
+#ifndef BIT
+	int g;
+#endif
+
+	/* order of the genomes in the frame */
+	for (ix = 0; ix < n_genome; ++ ix)
+	{
+		rank[ix].fitness = pool->fitness[ix];
+		rank[ix].ix = ix;
+	}
+	if (n_genome > head->fitmate)
+		qsort(&rank[head->fitmate], n_genome - head->fitmate, sizeof(Rank),
+			head->minimize ? cmp_rank_min : cmp_rank_max);
+
+	fj->fd = fd;
+	fj->i = i;
+	fj->offset = offset;
+	fj->size = size;
+
+	memset(buffer, 0, size);
+	frame->generation = l;
+	frame->island = island;
+	frame->n_genome = n_genome;
+	frame->final = final;
+
+	for (ix = 0; ix < n_genome; ++ ix)
+	{
+		fitness[ix] = rank[ix].fitness;
+		genome = (uint64_t *)poolframe_genome(head, frame, ix);
 #ifdef BIT
-            ci = get_bitgene(&pool[i].bitgenome[j]) ? '1':'0';
+		memcpy(genome, pool_bitgenome(pool, rank[ix].ix), head->n_word * sizeof(uint64_t));
 #else
-            ci = pool[i].genome[j] ? '1':'0';
+		for (g = 0; g < head->genenum; ++ g)
+			if (pool_genome(pool, rank[ix].ix)[g])
+				genome[g / 64] |= (uint64_t)1 << (g % 64);
 #endif
-            fwrite(&ci, sizeof(char), 1, outfile);
-        }
+	}
 
-        fwrite(&pool[i].fitness, sizeof(float), 1, outfile);
+	submit_write(writer, write_frame_job, fj); /* 'fj' belongs to the writer now */
 
-    }
-    fflush(outfile);
+	return offset + size;
+}
+
+/* header snapshot of a complete pool file */
+typedef struct
+{
+	int fd; /* pool file */
+	Poolhead head; /* header */
+	size_t end; /* end of the last frame */
+} Closejob;
+
+static void close_pool_job(void *data)
+{
+	Closejob *cj = (Closejob *)data;
+
+	if (pwrite(cj->fd, &cj->head, sizeof(Poolhead), 0) != (ssize_t)sizeof(Poolhead) ||
+		ftruncate(cj->fd, cj->end) != 0)
+	{
+		fprintf(stderr, "Exiting: cannot write pool file\n");
+		exit(1);
+	}
+	close(cj->fd);
+}
+
+/* complete the pool file after 'n_frame' frames ending at offset 'end', */
+/* once the frames queued before are written */
+static void close_pool_file(Writer *writer, int fd, Poolhead *head, int n_frame, size_t end)
+{
+	Closejob *cj = safe_malloc(sizeof(Closejob));
+
+	cj->fd = fd;
+	cj->head = *head;
+	cj->head.n_frame = n_frame;
+	cj->end = end;
+
+	submit_write(writer, close_pool_job, cj);
 }
 
 /*____________________________________________________________________________*/
@@ -420,13 +1143,13 @@ void print_pool_ascii(Pool *pool, Gapar *gaPar, FILE *outfile, int l, int fit)
 		for (j = 0; j < gaPar->genenum; ++ j)
 		{
 #ifdef BIT
-			fprintf(outfile, "%1d ", get_bitgene(&pool[i].bitgenome[j]));
+			fprintf(outfile, "%1d ", get_bitgene(pool_bitgenome(pool, i), j));
 #else
-			fprintf(outfile, "%1d ", pool[i].genome[j]);
+			fprintf(outfile, "%1d ", pool_genome(pool, i)[j]);
 #endif
 		}
 
-		fprintf(outfile, "%6.4f\n", pool[i].fitness);
+		fprintf(outfile, "%6.4f\n", pool->fitness[i]);
 
     }
     fprintf(outfile, "\n");
@@ -434,13 +1157,540 @@ void print_pool_ascii(Pool *pool, Gapar *gaPar, FILE *outfile, int l, int fit)
 }
 
 /*____________________________________________________________________________*/
-/* set output filename */
-void set_outfilename(char *outfilename, char c0, char c2, char c4, char c6)
+/* set output filename of repeat 'j' and jackknife fraction 'k' */
+/* digit encoding: this repeat _ last repeat . this fraction _ last fraction . extension */
+void set_outfilename(char *outfilename, Gapar *gaPar, int j, int k, const char *extension)
+{
+	sprintf(outfilename, "%d_%d.%d_%d.%s", j, gaPar->repeat - 1, k, gaPar->jackknife - 1, extension);
+}
+
+/*____________________________________________________________________________*/
+/* island model: sub-pools evolve on separate threads and pass copies of their */
+/* fittest genomes on to the next island in a ring every 'gaPar.migration' generations */
+typedef struct
+{
+	Pool pool; /* gene pool */
+	Memo memo; /* fitness of evaluated genomes */
+	int *average; /* equilibrium values of the fittest genomes */
+	int *genes; /* workspace of constrained breeding, per worker thread */
+	Pool outbox; /* fittest genomes, read by the next island */
+	int sent; /* last migration written to 'outbox' */
+	int received; /* last migration read from 'outbox' by the next island */
+	int converged; /* all genomes identical */
+	int l; /* generation reached */
+} Island;
+
+/* evolution of all islands for one repeat and jackknife fraction */
+typedef struct
+{
+	Gapar *gaPar; /* GA parameters */
+	Minset *ms; /* application data */
+	Island *island; /* islands */
+	int n_island; /* number of islands */
+	int slot; /* application slot of the first island */
+	int maxgenes; /* maximal number of selected genes, 0 for no constraint */
+	int j, k; /* repeat, jackknife fraction */
+	int start; /* first generation, > 0 for a resumed run */
+	Checkpoint *checkpoint; /* periodic checkpoints, 0 for none */
+	int poolfile; /* binary pool file, -1 for none */
+	Poolhead *poolhead; /* header of the binary pool file */
+	Writer *writer; /* output */
+} Evolution;
+
+/* copy genome and fitness at position 'ix' of 'from' to position 'iy' of 'to' */
+static void copy_genome(Pool *to, int iy, Pool *from, int ix, Gapar *gaPar)
+{
+#ifdef BIT
+	memcpy(pool_bitgenome(to, iy), pool_bitgenome(from, ix), BITWORDS(gaPar->genenum) * sizeof(uint64_t));
+#else
+	memcpy(pool_genome(to, iy), pool_genome(from, ix), gaPar->genenum * sizeof(int));
+#endif
+	to->fitness[iy] = from->fitness[ix];
+}
+
+/* number of genomes exchanged per migration */
+static int n_migrant(Gapar *gaPar)
+{
+	return (gaPar->fitmate < gaPar->popsize - gaPar->fitmate ?
+		gaPar->fitmate : gaPar->popsize - gaPar->fitmate);
+}
+
+/* migration number 'epoch' of island 'i': copy the fittest genomes to the outbox, */
+/* then replace the least fit genomes by those of the previous island; */
+/* the outboxes form a lock-free ring of single-slot mailboxes, where each island */
+/* waits only for its neighbours, which keeps the run independent of thread timing */
+static void migrate(Evolution *ev, int i, int epoch)
+{
+	int m;
+	Gapar *gaPar = ev->gaPar;
+	Island *is = &ev->island[i];
+	Island *from = &ev->island[(i + ev->n_island - 1) % ev->n_island];
+	int n = n_migrant(gaPar);
+
+	/* send, once the next island has taken the previous migrants */
+	while (__atomic_load_n(&is->received, __ATOMIC_ACQUIRE) < epoch - 1)
+		sched_yield();
+	for (m = 0; m < n; ++ m)
+		copy_genome(&is->outbox, m, &is->pool, m, gaPar);
+	__atomic_store_n(&is->sent, epoch, __ATOMIC_RELEASE);
+
+	/* receive; migrants keep their fitness */
+	while (__atomic_load_n(&from->sent, __ATOMIC_ACQUIRE) < epoch)
+		sched_yield();
+	for (m = 0; m < n; ++ m)
+		copy_genome(&is->pool, gaPar->popsize - n + m, &from->outbox, m, gaPar);
+	__atomic_store_n(&from->received, epoch, __ATOMIC_RELEASE);
+
+	sort_fitness(&is->pool, gaPar);
+}
+
+/* run all generations of island 'i' */
+static void evolve_island(void *pe, int i, int tid)
+{
+	Evolution *ev = (Evolution *)pe;
+	Gapar *gaPar = ev->gaPar;
+	Island *is = &ev->island[i];
+	int l, ix;
+	int epoch = ev->start / gaPar->migration;
+
+	/* initialise pool, constrained to the target subset size if required; */
+	/* a resumed pool continues from its checkpoint, where the fittest genomes */
+	/* have already been passed to the application */
+	if (ev->start == 0)
+		breed_pool(&is->pool, gaPar, is->average, ev->maxgenes, is->genes, ev->j, ev->k, -1, i, 0);
+	else
+		update_minset(&is->pool, gaPar, ev->ms, ev->k, ev->slot + i);
+
+	/* first generation starts at ix=0, following generations start at ix=gaPar.fitmate */
+	for (l = ev->start, ix = (l == 0 ? 0 : gaPar->fitmate); l < gaPar->generation; ++ l, ix = gaPar->fitmate)
+	{
+		if (i == 0 && gaPar->jobs == 1)
+		{
+			write_text(ev->writer, stdout, "%d/%d ", ev->k, l);
+		}
+
+		/* for the population size (minus gaPar.fitmate) */
+		evaluate_pool(&is->pool, gaPar, ev->ms, &is->memo, ev->j, ev->k, l, ev->slot + i, ix);
+
+		/*____________________________________________________________________________*/
+		/* sort pool */
+		sort_fitness(&is->pool, gaPar); /* fittest genomes to the top */
+
+		/* exchange fittest genomes with the neighbouring islands */
+		if (ev->n_island > 1 && (l + 1) % gaPar->migration == 0)
+			migrate(ev, i, ++ epoch);
+
+		/* append the evaluated pool to the pool file */
+		if (ev->poolfile >= 0 && gaPar->frames > 0 && (l + 1) % gaPar->frames == 0)
+			write_pool_frame(ev->writer, ev->poolfile, ev->poolhead, &is->pool, gaPar->popsize,
+				((l + 1) / gaPar->frames - 1) * ev->n_island + i, l, i, 0);
+
+		/* a single pool stops at convergence, islands are kept apart by migration */
+		if (ev->n_island == 1 && check_convergence(&is->pool, gaPar) == 0)
+		{
+			is->converged = 1;
+			break;
+		}
+
+		/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+		/* update application with the fittest genomes */
+		update_minset(&is->pool, gaPar, ev->ms, ev->k, ev->slot + i);
+		/*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<*/
+
+		/*____________________________________________________________________________*/
+		/* breed new generation */
+		breed_pool(&is->pool, gaPar, is->average, ev->maxgenes, is->genes, ev->j, ev->k, l, i, gaPar->fitmate);
+
+		/* store the bred pool, unless the run ends anyway */
+		if (ev->checkpoint != 0 && (l + 1) % gaPar->checkpoint == 0 && l + 1 < gaPar->generation)
+			save_checkpoint(ev->checkpoint, i, &is->pool, &is->memo, l);
+	}
+
+	is->l = l;
+}
+
+/* island holding the fittest genome */
+static int best_island(Island *island, int n_island, Gapar *gaPar)
+{
+	int i, best = 0;
+
+	for (i = 1; i < n_island; ++ i)
+		if ((gaPar->minimize && island[i].pool.fitness[0] < island[best].pool.fitness[0]) ||
+			(gaPar->maximize && island[i].pool.fitness[0] > island[best].pool.fitness[0]))
+			best = i;
+
+	return best;
+}
+
+/* print memo statistics of all islands */
+static void print_memo(Island *island, int n_island)
+{
+	int i;
+	long hit = 0, miss = 0;
+
+	for (i = 0; i < n_island; ++ i)
+	{
+		hit += island[i].memo.hit;
+		miss += island[i].memo.miss;
+	}
+
+	fprintf(stdout, "fitness memo: %ld hits, %ld misses\n", hit, miss);
+}
+
+/*____________________________________________________________________________*/
+/* independent GA runs (repeats and jackknife fractions), 'gaPar.jobs' at a time; */
+/* each concurrent run uses its own islands and application slots */
+
+/* outcome of one GA run */
+typedef struct
+{
+	int genenum; /* number of genes (proteins of the jackknife fraction) */
+	int genes; /* number of selected genes of the fittest genome */
+	int generations; /* number of generations run */
+	int converged; /* run stopped at convergence */
+	float fitness; /* fitness of the fittest genome */
+	double seconds; /* wall-clock time */
+	int done; /* run by this invocation, not completed before resuming */
+} Summary;
+
+/* continuation of a run of a resumed GA */
+typedef struct
+{
+	int checkpoint; /* the run continues from checkpoint 'fileName' */
+	Checkhead head; /* header of the checkpoint */
+	char fileName[200]; /* checkpoint file */
+} Resume;
+
+typedef struct
+{
+	Gapar *gaPar; /* GA parameters */
+	Minset *ms; /* application data */
+	Island *island; /* 'gaPar.islands' islands per concurrent run */
+	Summary *summary; /* outcome of each run */
+	int *run; /* runs of this invocation, in order */
+	int n_run; /* number of runs of this invocation */
+	Writer *writer; /* output */
+	Resume *resume; /* continuation of each run when resuming, 0 otherwise */
+} Schedule;
+
+/* wall-clock time in seconds */
+static double wall_time(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* results of a GA run, written after the pool has been handed on to the next run */
+typedef struct
+{
+	Gapar gaPar; /* GA parameters of the run */
+	Minset *ms; /* application data */
+	Pool pool; /* copy of the fittest genomes */
+	char outfilename[64]; /* pool output file */
+	int l; /* generation reached */
+	int j, k; /* repeat, jackknife fraction */
+} Report;
+
+static void write_report(void *data)
+{
+	Report *report = (Report *)data;
+	FILE *outfile;
+	char tmpfilename[68];
+
+	/* the pool output file appears once all results are written */
+	sprintf(tmpfilename, "%s.tmp", report->outfilename);
+	outfile = safe_open(tmpfilename, "w");
+	print_pool_ascii(&report->pool, &report->gaPar, outfile, report->l, 1); /* print to file */
+	fclose(outfile);
+	/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+	print_subset(&report->pool, &report->gaPar, report->ms, report->j, report->k);
+	/*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<*/
+	if (rename(tmpfilename, report->outfilename) != 0)
+	{
+		fprintf(stderr, "Exiting: cannot rename %s to %s\n", tmpfilename, report->outfilename);
+		exit(1);
+	}
+
+	free_pool(&report->pool);
+}
+
+/* remove file 'data' */
+static void remove_file(void *data)
+{
+	remove((char *)data);
+}
+
+/* GA run 'sc.run[i]' in job slot 'tid': */
+/* repeat run / 'gaPar.jackknife', fraction run % 'gaPar.jackknife' */
+static void run_ga(void *ps, int i, int tid)
+{
+	Schedule *sc = (Schedule *)ps;
+	Gapar runPar = *sc->gaPar; /* GA parameters of this run */
+	Gapar *gaPar = &runPar;
+	Minset *ms = sc->ms;
+	Summary *summary;
+	Resume *resume = 0;
+	Evolution ev;
+	Checkpoint checkpoint;
+	Poolhead poolhead;
+	Report *report;
+	int n_frame = 0; /* number of frames in the pool file */
+	size_t end; /* end of the pool file */
+	Island *island;
+	int n;
+	int best = 0; /* island holding the fittest genome */
+    char outfilename[64];
+    char checkfilename[64];
+	char *filename;
+    char poolfilename[64];
+	double start = wall_time();
+
+	i = sc->run[i];
+	summary = &sc->summary[i];
+	if (sc->resume != 0 && sc->resume[i].checkpoint)
+		resume = &sc->resume[i];
+
+	ev.gaPar = gaPar;
+	ev.ms = ms;
+	ev.writer = sc->writer;
+	ev.n_island = gaPar->islands;
+	ev.slot = tid * gaPar->islands;
+	ev.island = island = &sc->island[ev.slot];
+	ev.j = i / gaPar->jackknife;
+	ev.k = i % gaPar->jackknife;
+
+	/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+	/* one gene per protein of the jackknife fraction */
+	gaPar->genenum = ms->fold[ev.k].n_prot;
+	/* if required, constrain the size of genomes to the target subset size */
+	ev.maxgenes = (ms->subsetsize < 100. ? ms->fold[ev.k].n_selected : 0);
+	/*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<*/
+
+	/* start from empty islands: genomes, memo and parents of a previous run */
+	/* may belong to another jackknife fraction */
+	for (n = 0; n < gaPar->islands; ++ n)
+	{
+		clear_pool(&island[n].pool);
+		clear_pool(&island[n].outbox);
+		clear_memo(&island[n].memo);
+		island[n].sent = 0;
+		island[n].received = 0;
+		island[n].converged = 0;
+		/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
+		reset_minset(ms, ev.slot + n);
+		/*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<*/
+	}
+
+	/* continue the run from its checkpoint when resuming */
+	ev.start = 0;
+	if (resume != 0)
+	{
+		if (resume->head.genenum != gaPar->genenum)
+		{
+			fprintf(stderr, "Exiting: checkpoint %s has %d genes, the run has %d\n",
+				resume->fileName, resume->head.genenum, gaPar->genenum);
+			exit(1);
+		}
+		for (n = 0; n < gaPar->islands; ++ n)
+		{
+			load_checkpoint(resume->fileName, &resume->head, n, &island[n].pool, &island[n].memo);
+			island[n].sent = island[n].received = (resume->head.l + 1) / gaPar->migration;
+		}
+		ev.start = resume->head.l + 1;
+		write_text(sc->writer, stdout, "resuming repeat %d jackknife %d at generation %d\n",
+			ev.j, ev.k, ev.start);
+	}
+
+	/* store the state of the run every 'gaPar.checkpoint' generations */
+	ev.checkpoint = 0;
+	if (gaPar->checkpoint > 0)
+	{
+		set_outfilename(&checkfilename[0], gaPar, ev.j, ev.k, "ckpt");
+		init_checkpoint(&checkpoint, gaPar, &checkfilename[0], ev.j, ev.k);
+		ev.checkpoint = &checkpoint;
+	}
+
+	/* set output files; the pool output file of an earlier run is removed, */
+	/* it is written when the run is complete */
+	set_outfilename(&outfilename[0], gaPar, ev.j, ev.k, "ga");
+	remove(&outfilename[0]);
+	ev.poolfile = -1;
+	if (gaPar->poolbin)
+	{
+		set_outfilename(&poolfilename[0], gaPar, ev.j, ev.k, "pool");
+		ev.poolfile = open_pool_file(&poolfilename[0], &poolhead, gaPar, ev.j, ev.k);
+		ev.poolhead = &poolhead;
+	}
+
+	/*____________________________________________________________________________*/
+	/* for 'l' gaPar.generations */
+	if (gaPar->jobs == 1)
+		write_text(sc->writer, stdout, "jackknife (max %d) / generation (max %d) :\n",
+			gaPar->jackknife - 1, gaPar->generation - 1);
+	if (gaPar->islands > 1)
+		run_concurrent(gaPar->islands, evolve_island, &ev);
+	else
+		evolve_island(&ev, 0, 0);
+
+	/* the run is complete: stop checkpointing, the last checkpoint is */
+	/* removed once the results are written */
+	if (ev.checkpoint != 0)
+		finish_checkpoint(ev.checkpoint);
+
+	/* a converged pool is complete, otherwise take the island holding the fittest genome */
+	if (! island[0].converged)
+		best = best_island(island, gaPar->islands, gaPar);
+
+	summary->genenum = gaPar->genenum;
+	summary->genes = gene_sum(&island[best].pool, gaPar, 0);
+	summary->converged = island[0].converged;
+	summary->generations = island[best].l + summary->converged;
+	summary->fitness = island[best].pool.fitness[0];
+
+	if (gaPar->jobs == 1 && summary->converged)
+		write_text(sc->writer, stdout, "converged\n");
+	else if (gaPar->jobs > 1)
+		write_text(sc->writer, stdout, "repeat %d jackknife %d: fitness %6.4f after %d generations%s\n",
+			ev.j, ev.k, summary->fitness, summary->generations,
+			summary->converged ? ", converged" : "");
+
+	/*____________________________________________________________________________*/
+	/* print results from a copy of the fittest genomes */
+	report = safe_malloc(sizeof(Report));
+	report->gaPar = *gaPar;
+	report->ms = ms;
+	init_pool(&report->pool, gaPar, gaPar->fitmate);
+	for (n = 0; n < gaPar->fitmate; ++ n)
+		copy_genome(&report->pool, n, &island[best].pool, n, gaPar);
+	strcpy(report->outfilename, outfilename);
+	report->l = island[best].l;
+	report->j = ev.j;
+	report->k = ev.k;
+	submit_write(sc->writer, write_report, report);
+
+	if (ev.poolfile >= 0)
+	{
+		if (gaPar->frames > 0)
+			n_frame = summary->generations / gaPar->frames * gaPar->islands;
+		end = write_pool_frame(sc->writer, ev.poolfile, &poolhead, &island[best].pool,
+			gaPar->fitmate, n_frame, island[best].l, best, 1);
+		close_pool_file(sc->writer, ev.poolfile, &poolhead, n_frame + 1, end);
+	}
+
+	/* queued after the results, so that a crash before they are written */
+	/* leaves the checkpoint in place */
+	if (ev.checkpoint != 0)
+	{
+		filename = safe_malloc(strlen(checkfilename) + 1);
+		strcpy(filename, checkfilename);
+		submit_write(sc->writer, remove_file, filename);
+	}
+
+	summary->seconds = wall_time() - start;
+	summary->done = 1;
+}
+
+/* exit unless checkpoint 'head' from file 'fileName' belongs to this GA */
+static void check_checkhead(Checkhead *head, Gapar *gaPar, const char *fileName)
+{
+	if (head->seed != gaPar->seed ||
+		head->popsize != gaPar->popsize || head->fitmate != gaPar->fitmate ||
+		head->islands != gaPar->islands || head->migration != gaPar->migration ||
+		head->repeat != gaPar->repeat || head->jackknife != gaPar->jackknife)
+	{
+		fprintf(stderr, "Exiting: parameters differ from those of checkpoint %s\n"
+			"\tseed %d popsize %d fitmate %d islands %d migration %d repeat %d jackknife %d\n",
+			fileName, head->seed, head->popsize, head->fitmate, head->islands,
+			head->migration, head->repeat, head->jackknife);
+		exit(1);
+	}
+}
+
+/* runs of a GA resumed from checkpoint 'gaPar.resumeFileName': */
+/* runs are started in order, so every run before the one of the checkpoint */
+/* was started by the interrupted GA; such a run is complete if its pool output */
+/* file exists, which is written last, and it has no checkpoint left; */
+/* runs with a checkpoint continue from it, all others start again */
+static void schedule_resume(Schedule *sc, Gapar *gaPar)
+{
+	int i, j, k;
+	int first; /* run of the checkpoint */
+	char outfilename[64];
+	Checkhead head;
+	Resume *resume;
+
+	read_checkhead(gaPar->resumeFileName, &head);
+	gaPar->seed = head.seed;
+	check_checkhead(&head, gaPar, gaPar->resumeFileName);
+	first = head.j * gaPar->jackknife + head.k;
+
+	sc->resume = safe_malloc(gaPar->repeat * gaPar->jackknife * sizeof(Resume));
+	for (i = 0; i < gaPar->repeat * gaPar->jackknife; ++ i)
+	{
+		resume = &sc->resume[i];
+		j = i / gaPar->jackknife;
+		k = i % gaPar->jackknife;
+
+		/* the checkpoint given, or the checkpoint file of the run */
+		resume->checkpoint = 0;
+		if (i == first)
+		{
+			resume->head = head;
+			strcpy(resume->fileName, gaPar->resumeFileName);
+			resume->checkpoint = 1;
+		}
+		else
+		{
+			set_outfilename(resume->fileName, gaPar, j, k, "ckpt");
+			if (access(resume->fileName, F_OK) == 0)
+			{
+				read_checkhead(resume->fileName, &resume->head);
+				check_checkhead(&resume->head, gaPar, resume->fileName);
+				if (resume->head.j != j || resume->head.k != k)
+				{
+					fprintf(stderr, "Exiting: checkpoint %s is not that of repeat %d jackknife %d\n",
+						resume->fileName, j, k);
+					exit(1);
+				}
+				resume->checkpoint = 1;
+			}
+		}
+
+		set_outfilename(outfilename, gaPar, j, k, "ga");
+		if (i < first && ! resume->checkpoint && access(outfilename, F_OK) == 0)
+			fprintf(stdout, "repeat %d jackknife %d is complete\n", j, k);
+		else
+			sc->run[sc->n_run ++] = i;
+	}
+}
+
+/* print the outcome of all runs, in the order of repeats and jackknife fractions */
+static void print_summary(Schedule *sc)
 {
-	outfilename[0] = c0;
-	outfilename[2] = c2;
-	outfilename[4] = c4;
-	outfilename[6] = c6;
+	int i;
+	Gapar *gaPar = sc->gaPar;
+	Summary *summary;
+	FILE *summaryFile = safe_open("runs.summary", "w");
+
+	fprintf(summaryFile, "# repeat jackknife genenum genes generations converged fitness seconds\n");
+	for (i = 0; i < gaPar->repeat * gaPar->jackknife; ++ i)
+	{
+		summary = &sc->summary[i];
+		if (! summary->done)
+		{
+			fprintf(summaryFile, "# %d %d completed before resuming\n",
+				i / gaPar->jackknife, i % gaPar->jackknife);
+			continue;
+		}
+		fprintf(summaryFile, "%d %d %d %d %d %d %6.4f %.3f\n",
+			i / gaPar->jackknife, i % gaPar->jackknife,
+			summary->genenum, summary->genes, summary->generations,
+			summary->converged, summary->fitness, summary->seconds);
+	}
+
+	fclose(summaryFile);
 }
 
 /*____________________________________________________________________________*/
@@ -481,6 +1731,26 @@ void parametrise_ga(Gapar *gaPar)
 	/* split database and/or repeat GA */
 	gaPar->jackknife = (int)JACKKNIFE; assert(gaPar->jackknife > 0);
 	gaPar->repeat = (int)REPEAT; assert(gaPar->repeat > 0);
+
+	/* parallel execution */
+	gaPar->threads = (int)THREADS; assert(gaPar->threads > 0);
+	gaPar->islands = (int)ISLANDS; assert(gaPar->islands > 0);
+	gaPar->migration = (int)MIGRATION; assert(gaPar->migration > 0);
+	gaPar->jobs = (int)JOBS; assert(gaPar->jobs > 0);
+
+	/* random numbers: seed 0 is replaced by a clock seed after argument parsing */
+	gaPar->seed = (int)SEED; assert(gaPar->seed >= 0);
+
+	/* genome constraint */
+	gaPar->fill = (int)FILL;
+
+	/* checkpoints */
+	gaPar->checkpoint = (int)CHECKPOINT; assert(gaPar->checkpoint >= 0);
+	strcpy(gaPar->resumeFileName, RESUME);
+
+	/* binary pool file */
+	gaPar->poolbin = (int)POOLBIN;
+	gaPar->frames = (int)FRAMES; assert(gaPar->frames >= 0);
 }
 
 /*____________________________________________________________________________*/
@@ -506,10 +1776,20 @@ void parse_args_ga(int argc, char **argv, Gapar *gaPar)
 		{"equilibrium", required_argument, 0, 13},
 		{"jackknife", required_argument, 0, 14},
 		{"repeat", required_argument, 0, 15},
+		{"threads", required_argument, 0, 16},
+		{"fill", required_argument, 0, 17},
+		{"seed", required_argument, 0, 18},
+		{"islands", required_argument, 0, 19},
+		{"migration", required_argument, 0, 20},
+		{"jobs", required_argument, 0, 21},
+		{"checkpoint", required_argument, 0, 22},
+		{"resume", required_argument, 0, 23},
+		{"poolbin", required_argument, 0, 24},
+		{"frames", required_argument, 0, 25},
 		{0, 0, 0, 0}
 	};
 
-	while ((c = getopt_long (argc, argv, "1:2:3:4:5:6:7:8:9:10:11:12:13:14:15:", long_options, NULL)) != -1)
+	while ((c = getopt_long (argc, argv, "1:2:3:4:5:6:7:8:9:10:11:12:13:14:15:16:17:18:19:20:21:22:23:24:25:", long_options, NULL)) != -1)
 	{
 		switch(c)
 		{
@@ -573,6 +1853,46 @@ void parse_args_ga(int argc, char **argv, Gapar *gaPar)
 				gaPar->repeat = atoi(optarg);
 				fprintf(stdout, "REPEAT set to value %d\n", gaPar->repeat);
 				break;
+			case 16:
+				gaPar->threads = atoi(optarg);
+				fprintf(stdout, "THREADS set to value %d\n", gaPar->threads);
+				break;
+			case 17:
+				gaPar->fill = atoi(optarg);
+				fprintf(stdout, "FILL set to value %d\n", gaPar->fill);
+				break;
+			case 18:
+				gaPar->seed = atoi(optarg);
+				fprintf(stdout, "SEED set to value %d\n", gaPar->seed);
+				break;
+			case 19:
+				gaPar->islands = atoi(optarg);
+				fprintf(stdout, "ISLANDS set to value %d\n", gaPar->islands);
+				break;
+			case 20:
+				gaPar->migration = atoi(optarg);
+				fprintf(stdout, "MIGRATION set to value %d\n", gaPar->migration);
+				break;
+			case 21:
+				gaPar->jobs = atoi(optarg);
+				fprintf(stdout, "JOBS set to value %d\n", gaPar->jobs);
+				break;
+			case 22:
+				gaPar->checkpoint = atoi(optarg);
+				fprintf(stdout, "CHECKPOINT set to value %d\n", gaPar->checkpoint);
+				break;
+			case 23:
+				strcpy(gaPar->resumeFileName, optarg);
+				fprintf(stdout, "RESUME set to name %s\n", gaPar->resumeFileName);
+				break;
+			case 24:
+				gaPar->poolbin = atoi(optarg);
+				fprintf(stdout, "POOLBIN set to value %d\n", gaPar->poolbin);
+				break;
+			case 25:
+				gaPar->frames = atoi(optarg);
+				fprintf(stdout, "FRAMES set to value %d\n", gaPar->frames);
+				break;
 			default:
 				/*usage();*/
 				break;	
@@ -584,12 +1904,12 @@ void parse_args_ga(int argc, char **argv, Gapar *gaPar)
 /* main function */
 int main(int argc, char **argv)
 {
-    int i = 0, j = 0, k = 0, l = 0, ix = 0, iy = 0; /* counters */
+    int i = 0; /* counter */
 	FILE *outfile = 0;
-    /* digit encoding of 'pool' output files: */
-    /* 1.: this repat, 2. gaPar.repga, 3. this fraction, 4. gaPar.jackknife */
-    char outfilename[13] = "0_0.0_0.ga";
-	int *average = 0;
+	Island *island = 0; /* sub-pools of all concurrent runs */
+	int n_island = 0; /* number of islands of all concurrent runs */
+	Schedule sc; /* GA runs */
+	Writer writer; /* background output */
 
     /*____________________________________________________________________________*/
 	/* print program license */
@@ -610,129 +1930,86 @@ int main(int argc, char **argv)
 
     /*____________________________________________________________________________*/
 	/* initialise GA */
-    Pool pool[gaPar.popsize]; /* gene pool */
-	/* average values for equilibrium */
-	if (gaPar.equilibrium)
-		average = safe_malloc(gaPar.popsize * sizeof(int)); 
+	/* all runs, or the incomplete runs of a resumed GA */
+	sc.run = safe_malloc(gaPar.repeat * gaPar.jackknife * sizeof(int));
+	sc.n_run = 0;
+	sc.resume = 0;
+	if (strlen(gaPar.resumeFileName) > 0)
+		schedule_resume(&sc, &gaPar);
+	else
+		for (i = 0; i < gaPar.repeat * gaPar.jackknife; ++ i)
+			sc.run[sc.n_run ++] = i;
+
+	/* parameters as used, with the seed of a resumed GA */
+	print_pars(&gaPar, &ms, outfile);
+
+	/* no more concurrent runs than runs */
+	if (gaPar.jobs > sc.n_run && sc.n_run > 0)
+		gaPar.jobs = sc.n_run;
+	n_island = gaPar.jobs * gaPar.islands;
+	island = safe_malloc(n_island * sizeof(Island));
 
     /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 	/* initialise application */
-	initialise_minset(&pool[0], &gaPar, &ms);
+	initialise_minset(&island[0].pool, &gaPar, &ms);
+
+	/* only pack the base set into a corpus file */
+	if (strlen(ms.packFileName) > 0)
+	{
+		pack_corpus(&ms, ms.packFileName);
+		fprintf(stdout, "Wrote corpus file %s\n", ms.packFileName);
+		free(island);
+		finalise_minset(&ms);
+		return 0;
+	}
     /*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<*/
 
     /*____________________________________________________________________________*/
-	/* allocate genomes */
-    for(i = 0; i < gaPar.popsize; ++ i) /* allocate memory to genomes */
+	/* allocate islands: genomes, fitness memo and average values for equilibrium */
+	for (i = 0; i < n_island; ++ i)
 	{
-#ifdef BIT
-		pool[i].bitgenome = safe_malloc(sizeof(Bitgene) * gaPar.genenum); /* bitgene pool */
-#else
-        pool[i].genome = safe_malloc(sizeof(int) * gaPar.genenum); /* gene pool */
-#endif
+		init_pool(&island[i].pool, &gaPar, gaPar.popsize);
+		init_pool(&island[i].outbox, &gaPar, n_migrant(&gaPar));
+		init_memo(&island[i].memo, &gaPar);
+		island[i].average = 0;
+		if (gaPar.equilibrium)
+			island[i].average = safe_malloc(gaPar.genenum * sizeof(int)); 
+		island[i].genes = safe_malloc(island_threads(&gaPar) * gaPar.genenum * sizeof(int));
 	}
 
-    /*____________________________________________________________________________*/
-	/* run GA */
-    /* repeat entire GA */
-    for (j = 0;  j < gaPar.repeat; ++ j)
-    {
-        /* set the starting point for pseudorandom integers */
-        srand((unsigned int)(time(NULL)%10000));
-
-        /* repeat for each gaPar.jackknife fraction */
-        for (k = 0;  k < gaPar.jackknife; ++ k)
-        {
-            /*____________________________________________________________________________*/
-			/* initialise pool */
-			if (gaPar.random)
-				init_random_pool(&pool[0], &gaPar); /* random pool */
-			if (gaPar.seeded)
-				init_seeded_pool(&pool[0], &gaPar); /* seeded pool */
-
-			/* if required, constrain the size the newly generated pool */
-			if (ms.subsetsize < 100.)
-				for (iy = 0; iy < gaPar.popsize; ++ iy)
-					constrain_genome(&pool[0], &gaPar, iy, ms.n_selected);
-
-			/* set output file */
-			outfile = safe_open(&outfilename[0], "w");
-
-            /*____________________________________________________________________________*/
-			/* for 'l' gaPar.generations */
-			fprintf(stdout, "jackknife (max %d) / generation (max %d) :\n",
-				gaPar.jackknife - 1, gaPar.generation - 1);
-			/* first generation starts at ix=0, following generations start at ix=gaPar.fitmate */
-            for (l = 0, ix = 0; l < gaPar.generation; ++ l, ix = gaPar.fitmate)
-            {
-				fprintf(stdout, "%d/%d ", k, l);
-				fflush(stdout);
-
-				/* for the population size (minus gaPar.fitmate) */
-                for ( ; ix < gaPar.popsize; ++ ix)
-                {
-					/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
-					/* run application */
-					/* application returns genome fitness unless identical genome already in memory */
-					if (mem_fitness(&pool[0], &gaPar, ix) == 0)
-						pool[ix].fitness = run_minset(&pool[0], &gaPar, &ms, j, k, l, ix);
-					/*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<*/
-                }
-
-				/*____________________________________________________________________________*/
-				/* sort pool */
-                sort_fitness(&pool[0], &gaPar); /* sort pool by fitness */
-                
-				if (check_convergence(&pool[0], &gaPar) == 0)
-				{
-					fprintf(stdout, "converged\n");
-					/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
-					/* print results */
-					print_pool_ascii(&pool[0], &gaPar, outfile, l, 1); /* print to file */
-					fclose(outfile);
-					print_subset(&pool[0], &gaPar, &ms);
-					/*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<*/
-					exit(0);
-				}
+	sc.gaPar = &gaPar;
+	sc.ms = &ms;
+	sc.island = island;
+	sc.summary = safe_malloc(gaPar.repeat * gaPar.jackknife * sizeof(Summary));
+	for (i = 0; i < gaPar.repeat * gaPar.jackknife; ++ i)
+		sc.summary[i].done = 0;
+	sc.writer = &writer;
+	init_writer(&writer);
 
-				/*____________________________________________________________________________*/
-				/* breed new generation */
-                for (iy = gaPar.fitmate; iy < gaPar.popsize; ++ iy)
-                {
-					if (gaPar.crossover)
-						breed_crossover(&pool[0], &gaPar, iy); 
-					if (gaPar.equilibrium)
-					{
-						equilibrium(&pool[0], &gaPar, &average[0]); /* equilibrium values */
-						breed_equilibrium(&pool[0], &gaPar, &average[0], iy);
-					}
-                }
-
-				/* if required, constrain the size the newly generated pool */
-				if (ms.subsetsize < 100.)
-					for (iy = gaPar.fitmate; iy < gaPar.popsize; ++ iy)
-						constrain_genome(&pool[0], &gaPar, iy, ms.n_selected);
-            }
-        }
-    }
+    /*____________________________________________________________________________*/
+	/* run GA: repeat entire GA for each gaPar.jackknife fraction */
+	run_parallel(gaPar.jobs, sc.n_run, run_ga, &sc);
+	finish_writer(&writer); /* all output is written */
 
-	/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
-	/* print results */
-	print_pool_ascii(&pool[0], &gaPar, outfile, l, 1); /* print to file */
-    fclose(outfile);
-	print_subset(&pool[0], &gaPar, &ms);
-	/*<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<*/
+	if (gaPar.repeat * gaPar.jackknife > 1)
+		print_summary(&sc);
+	print_memo(island, n_island);
 
     /*____________________________________________________________________________*/
 	/* finalise GA */
     /* free memory */
-    for (i = 0; i < gaPar.popsize; ++ i)
+	for (i = 0; i < n_island; ++ i)
 	{
-#ifdef BIT
-        free(pool[i].bitgenome);
-#else
-        free(pool[i].genome);
-#endif
+		free_pool(&island[i].pool);
+		free_pool(&island[i].outbox);
+		free_memo(&island[i].memo);
+		free(island[i].average);
+		free(island[i].genes);
 	}
+	free(island);
+	free(sc.summary);
+	free(sc.run);
+	free(sc.resume);
 
 	/*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 	/* finalise application */
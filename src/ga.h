@@ -25,13 +25,20 @@ ga : Genetic Algorithm
 #include <alloca.h>
 #include <assert.h>
 #include <ctype.h>
+#include <fcntl.h>
 #include <getopt.h>
 #include <limits.h>
 #include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
+
+#include "rng.h"
 
 /*____________________________________________________________________________*/
 /* define debug mode and debug 'dump' function */
@@ -40,27 +47,60 @@ ga : Genetic Algorithm
 #define dump2(x1, fmt1, x2, fmt2) fprintf(stderr, "dump2@%s:%u: %s=" fmt1"\t%s=" fmt2"\n", __FILE__, __LINE__, #x1, x1, #x2, x2);
 
 /*____________________________________________________________________________*/
-/* structures */
+/* binary genes packed into 64-bit words; comment out for integer genes */
+#define BIT
 
-/* bit field for binary gene */
 #ifdef BIT
+#define BITWORD 64 /* number of genes per genome word */
+#define BITWORDS(n) (((n) + BITWORD - 1) / BITWORD) /* number of words for 'n' genes */
+#endif
+
+/* alignment (bytes) of the genome block and of each genome in it: one cache line */
+#define POOL_ALIGN 64
+
+/*____________________________________________________________________________*/
+/* structures */
+
+/* genome rank: fitness and pool index */
 typedef struct
 {
-	unsigned int state: 1; /* 1 bit integer */
-} Bitgene;
-#endif
+	float fitness; /* fitness of genome */
+	int ix; /* index of genome in pool */
+} Rank;
 
-/* genome pool */
+/* genome pool: all genomes in one contiguous block, one aligned row per genome; */
+/* sorting permutes 'order' and 'fitness', genomes stay in their rows */
 typedef struct
 {
 #ifdef BIT
-	Bitgene *bitgenome; /* bitgenome is an array of binary parameters=bitgenes */
+	uint64_t *bitgenome; /* bitgenome is a bitset of binary parameters=bitgenes, */
+						/* unused bits of the last word are 0 */
 #else
     int *genome; /* genome is an array of parameters=genes */
 #endif
-    float fitness; /* fitness of genome */
+	int stride; /* words (genes) per row, padded to the alignment */
+	int *order; /* row of the genome at each pool position */
+    float *fitness; /* fitness of the genome at each pool position */
+	Rank *rank; /* sorting workspace */
+	int *sorted; /* sorting workspace: new order */
+	int size; /* number of genomes */
 } Pool;
 
+/* fitness memo: hash table of evaluated genomes, kept across generations */
+typedef struct
+{
+	int size; /* number of slots (power of 2) */
+	int n_word; /* number of 64-bit words of a packed genome */
+	int bits; /* genes are packed as single bits (binary genes) */
+	uint64_t *key; /* packed genomes, 'n_word' words per slot */
+	uint64_t *hash; /* 128-bit genome hashes, 2 words per slot */
+	float *fitness; /* genome fitness */
+	char *state; /* MEMO_EMPTY, MEMO_PENDING or MEMO_KNOWN */
+	uint64_t *scratch; /* packed genome being looked up */
+	long hit; /* number of genomes found in the memo */
+	long miss; /* number of genomes not found */
+} Memo;
+
 /*>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>*/
 /* basic GA parameters */
 typedef struct
@@ -89,14 +129,76 @@ typedef struct
 	/* repeats */
 	int jackknife; /* splitting of database in 'JACKKNIFE' parts (1 = no jackknife) */
 	int repeat; /* repeat entire GA 'REPEAT' times (1 = no repeat) */
+
+	/* parallel execution */
+	int threads; /* number of worker threads for fitness evaluation */
+	int islands; /* number of sub-pools (islands) evolving on separate threads */
+	int migration; /* generations between migrations of the fittest genomes */
+	int jobs; /* number of GA runs (repeats, jackknife fractions) at a time */
+
+	/* random numbers */
+	int seed; /* seed of random number streams */
+
+	/* genome constraint */
+	int fill; /* constrained genomes are filled up to the target gene number */
+
+	/* checkpoints */
+	int checkpoint; /* generations between checkpoints, 0 for none */
+	char resumeFileName[200]; /* checkpoint file to resume from, empty for none */
+
+	/* binary pool file */
+	int poolbin; /* write gene pools to a binary pool file */
+	int frames; /* generations between frames of all island pools, 0 for none */
 } Gapar;
 
+/*____________________________________________________________________________*/
+/* genome at pool position 'ix' */
+#ifdef BIT
+static inline uint64_t *pool_bitgenome(const Pool *pool, int ix)
+{
+	return &pool->bitgenome[(size_t)pool->order[ix] * pool->stride];
+}
+#else
+static inline int *pool_genome(const Pool *pool, int ix)
+{
+	return &pool->genome[(size_t)pool->order[ix] * pool->stride];
+}
+#endif
+
+/*____________________________________________________________________________*/
+/* bitgenome accessors */
+#ifdef BIT
+/* return integer 0 or 1, depending on the state of gene 'i' */
+static inline int get_bitgene(const uint64_t *bitgenome, int i)
+{
+	return (int)((bitgenome[i / BITWORD] >> (i % BITWORD)) & 1);
+}
+
+/* set state of gene 'i' to either 0 or 1, depending on passed integer 'state' */
+static inline void set_bitgene(uint64_t *bitgenome, int i, int state)
+{
+	if (state > 0)
+		bitgenome[i / BITWORD] |= (uint64_t)1 << (i % BITWORD);
+	else
+		bitgenome[i / BITWORD] &= ~((uint64_t)1 << (i % BITWORD));
+}
+#endif
+
 /*____________________________________________________________________________*/
 /* prototypes */
 FILE *safe_open(const char *name, const char *mode);
 extern void *safe_malloc(size_t), *safe_realloc(void *, size_t);
-int mem_fitness(Pool *pool, Gapar *gapar, int ix);
-void constrain_genome(Pool *pool, Gapar *gapar, int ix, int maxgenes);
-void set_outfilename(char *outfilename, char c0, char c2, char c4, char c6);
+void *safe_aligned_malloc(size_t alignment, size_t size);
+void init_pool(Pool *pool, Gapar *gapar, int size);
+void clear_pool(Pool *pool);
+void free_pool(Pool *pool);
+void init_memo(Memo *memo, Gapar *gapar);
+void clear_memo(Memo *memo);
+void free_memo(Memo *memo);
+int memo_fitness(Memo *memo, Pool *pool, Gapar *gapar, int ix, int *slot);
+void constrain_genome(Pool *pool, Gapar *gapar, int ix, int maxgenes, Rng *rng, int *index);
+void set_outfilename(char *outfilename, Gapar *gapar, int j, int k, const char *extension);
+void run_parallel(int nthreads, int n, void (*work)(void *arg, int i, int tid), void *arg);
+int island_threads(Gapar *gaPar);
 
 #endif
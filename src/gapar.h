@@ -45,5 +45,29 @@ gapar.h : GA default parameters
 #define JACKKNIFE 1 /* split into 'JACKKNIFE' parts */
 #define REPEAT 1 /* repeat GA 'REPEAT' times */
 
+/* parallel execution */
+#define THREADS 1 /* number of worker threads for fitness evaluation */
+#define ISLANDS 1 /* number of sub-pools evolving on separate threads */
+#define MIGRATION 10 /* generations between exchanges of fittest genomes among islands */
+#define JOBS 1 /* number of repeats and jackknife fractions run concurrently */
+
+/* random numbers */
+#define SEED 0 /* seed of random number streams, 0: seed from clock */
+
+/* genome constraint */
+#define FILL 0 /* constrained genomes are filled up to the target gene number */
+
+/* checkpoints */
+#define CHECKPOINT 0 /* generations between checkpoints of a GA run, 0: no checkpoints */
+#define RESUME "" /* checkpoint file to resume from, "": start new runs */
+
+/* binary pool file */
+#define POOLBIN 0 /* write gene pools to a binary pool file */
+#define FRAMES 0 /* generations between pool file frames, 0: final pool only */
+
+/* fitness memo */
+#define MEMO 8 /* capacity of the fitness memo (genomes) in units of population size */
+#define MEMO_PROBE 8 /* maximal number of slots probed per genome */
+
 #endif
 
@@ -4,35 +4,110 @@ getseqs.c : Read alignment of FASTA sequences
 ==============================================================================*/
 
 #include <ctype.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "minset.h"
 
 /*____________________________________________________________________________*/
-static int read_sequence_name(FILE *file, ProteinEntry *protein)
+/* character classes of sequence files */
+#define SEQ_ALPHA 1 /* residue */
+#define SEQ_SPACE 2 /* white space, skipped */
+#define SEQ_GAP 4 /* gap '.', skipped */
+#define SEQ_PRINT 8 /* printable, part of a header line */
+
+static unsigned char seq_class[256]; /* class bits of each character */
+static unsigned char seq_upper[256]; /* upper case of each character */
+static pthread_once_t seq_once = PTHREAD_ONCE_INIT;
+
+/*____________________________________________________________________________*/
+static void init_seq_class(void)
+{
+	int ch;
+
+	for (ch = 0; ch < 256; ++ ch)
+	{
+		seq_class[ch] = (isalpha(ch) ? SEQ_ALPHA : 0) | (isspace(ch) ? SEQ_SPACE : 0) |
+			(ch == '.' ? SEQ_GAP : 0) | (isprint(ch) ? SEQ_PRINT : 0);
+		seq_upper[ch] = toupper(ch);
+	}
+}
+
+/*____________________________________________________________________________*/
+void open_seqfile(Seqfile *sf, const char *fileName)
+{
+	pthread_once(&seq_once, init_seq_class);
+
+	sf->file = safe_open(fileName, "r");
+	sf->block = safe_malloc(SEQ_BLOCK);
+	sf->pos = 0;
+	sf->n = 0;
+}
+
+/*____________________________________________________________________________*/
+/* read the next block if the current one is used up; 0 at end of file */
+static int fill_block(Seqfile *sf)
+{
+	if (sf->pos < sf->n)
+		return 1;
+
+	sf->n = fread(sf->block, 1, SEQ_BLOCK, sf->file);
+	sf->pos = 0;
+
+	return (sf->n > 0);
+}
+
+/*____________________________________________________________________________*/
+void close_seqfile(Seqfile *sf)
+{
+	fclose(sf->file);
+	free(sf->block);
+}
+
+/*____________________________________________________________________________*/
+static int read_sequence_name(Seqfile *sf, ProteinEntry *protein)
 {
     /* Reads a line starting with '>' and followed by the sequence name */
     /* Leading white space is skipped.  Reading proceeds until the end  */
     /* of the line is reached.  The name is read into sequence->name.   */
 
-    int ch, length = 0, allocated = 64;
+    size_t i, length = 0, allocated = 64;
 
-    while ((ch = getc(file)) != EOF && isspace(ch))
-	;
+    while (fill_block(sf) && (seq_class[sf->block[sf->pos]] & SEQ_SPACE))
+		++ sf->pos;
 
-    if (ch != '>')
+    if (! fill_block(sf) || sf->block[sf->pos] != '>')
 		return 0;
 
     protein->description = safe_malloc(allocated);
 
-    do
+	/* copy printable characters block by block, up to the end of the line */
+	for (;;)
 	{
-		protein->description[length ++] = ch;
+		for (i = sf->pos; i < sf->n && (seq_class[sf->block[i]] & SEQ_PRINT); ++ i)
+			;
 
-		if (length == allocated)
-			protein->description = safe_realloc(protein->description, allocated += 64);
-    } while ((ch = getc(file)) != EOF && ch != '\n' && isprint(ch));
+		if (length + (i - sf->pos) + 1 > allocated)
+		{
+			while (length + (i - sf->pos) + 1 > allocated)
+				allocated *= 2;
+			protein->description = safe_realloc(protein->description, allocated);
+		}
+		memcpy(&protein->description[length], &sf->block[sf->pos], i - sf->pos);
+		length += i - sf->pos;
+		sf->pos = i;
+
+		/* skip the character ending the line */
+		if (sf->pos < sf->n)
+		{
+			++ sf->pos;
+			break;
+		}
+		if (! fill_block(sf))
+			break;
+	}
 
     protein->description[length] = '\0';
 
@@ -40,36 +115,48 @@ static int read_sequence_name(FILE *file, ProteinEntry *protein)
 }
 
 /*____________________________________________________________________________*/
-static void read_sequence_residues(FILE *file, ProteinEntry *protein)
+static void read_sequence_residues(Seqfile *sf, Prots *prots, ProteinEntry *protein)
 {
     /* Reads the residues in a sequence, up to (but not including) the      */
     /* next sequence header (starting with '>'), or up to end of file.      */
     /* Residues may span multiple lines.  White space and gaps are skipped. */
     /* Nonalpha characters are rejected, resulting in an error message.     */
-    /* Alpha characters are NOT converted to upper case.  The string is read*/
+    /* Alpha characters are converted to upper case.  The string is read    */
     /* into sequence->residues and zero-terminated; the length is stored    */
     /* into sequence->length.                                               */
+    /* Sequences are appended to the buffer 'prots.residues', which grows   */
+    /* geometrically; 'protein.offset' locates the sequence in the buffer.  */
 
-    int ch, length = 0, allocated = 64;
+    size_t i, length = 0;
+	unsigned char ch;
+    char *seq;
 
-    protein->seq = safe_malloc(allocated);
+    protein->offset = prots->n_residue;
 
-    while ((ch = getc(file)) != EOF && ch != '>')
-		if (isalpha(ch))
+    while (fill_block(sf) && sf->block[sf->pos] != '>')
+	{
+		/* keep space for all residues of this block and the terminator */
+		if (protein->offset + length + (sf->n - sf->pos) + 1 > prots->allocated)
 		{
-			protein->seq[length ++] = toupper(ch);
-
-			if (length == allocated)
-				protein->seq = safe_realloc(protein->seq, allocated += 64);
+			while (protein->offset + length + (sf->n - sf->pos) + 1 > prots->allocated)
+				prots->allocated = 2 * prots->allocated + 64;
+			prots->residues = safe_realloc(prots->residues, prots->allocated);
 		}
-		else if (ch != '.' && !isspace(ch))
+		seq = &prots->residues[protein->offset];
+
+		for (i = sf->pos; i < sf->n && sf->block[i] != '>'; ++ i)
 		{
-			fprintf(stderr, "illegal character '%c' in protein sequence\n", ch);
-			exit(1);
+			ch = sf->block[i];
+			if (seq_class[ch] & SEQ_ALPHA)
+				seq[length ++] = seq_upper[ch];
+			else if (! (seq_class[ch] & (SEQ_SPACE | SEQ_GAP)))
+			{
+				fprintf(stderr, "illegal character '%c' in protein sequence\n", ch);
+				exit(1);
+			}
 		}
-
-    if (ch == '>')
-		ungetc('>', file);
+		sf->pos = i;
+	}
 
     if (length == 0)
 	{
@@ -77,18 +164,21 @@ static void read_sequence_residues(FILE *file, ProteinEntry *protein)
 		exit(1);
     }
 
-    protein->seq[length] = '\0';
+	seq = &prots->residues[protein->offset];
+    seq[length] = '\0';
+    protein->length = length;
+    prots->n_residue += length + 1;
 }
 
 /*____________________________________________________________________________*/
-int read_sequence(FILE *file, Prots *prots, int k)
+/* read the next record of sequence file 'sf' into protein 'k'; 0 if none is left */
+int read_sequence(Seqfile *sf, Prots *prots, int k)
 {
-    if (read_sequence_name(file, &prots->protein[k]))
+    if (read_sequence_name(sf, &prots->protein[k]))
 	{
-		read_sequence_residues(file, &prots->protein[k]);
+		read_sequence_residues(sf, prots, &prots->protein[k]);
 		return 1;
     }
 	else
 		return 0;
 }
-
@@ -7,6 +7,23 @@ getseqs.c : Read alignment of FASTA sequences
 #define GETSEQS_H
 
 /*___________________________________________________________________________*/
+/* includes */
+#include <stdio.h>
 
+/*___________________________________________________________________________*/
+/* defines */
+#define SEQ_BLOCK 65536 /* size of the blocks read from sequence files */
+
+/*___________________________________________________________________________*/
+/* structures */
+
+/* sequence file, read in blocks of SEQ_BLOCK bytes */
+typedef struct
+{
+	FILE *file;
+	unsigned char *block; /* current block */
+	size_t pos; /* next unread byte in 'block' */
+	size_t n; /* number of bytes in 'block' */
+} Seqfile;
 
 #endif
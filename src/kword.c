@@ -0,0 +1,268 @@
+/*==============================================================================
+kword.c : k-word (fixed-length substring) counts of sequences
+(C) 2006-2017 Jens Kleinjung
+(C) 2006-2007 Alessandro Pandini
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+==============================================================================*/
+
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ga.h"
+#include "kword.h"
+
+/*____________________________________________________________________________*/
+/* test whether all k-words of length 'kword_len' over 'base' ranks fit into a code */
+int kword_fits(int kword_len, int base)
+{
+	int i;
+	uint64_t max = UINT64_MAX;
+
+	for (i = 0; i < kword_len; ++ i)
+		max /= base;
+
+	return (max > 0);
+}
+
+/*____________________________________________________________________________*/
+/* comparison of k-word codes used by 'qsort' */
+static int cmp_code(const void *pc1, const void *pc2)
+{
+	uint64_t c1 = *(uint64_t *)pc1;
+	uint64_t c2 = *(uint64_t *)pc2;
+
+	return (c1 > c2) - (c1 < c2);
+}
+
+/*____________________________________________________________________________*/
+/* count all k-words of sequence 'seq' into a sparse histogram */
+/* k-words spanning a non-alphabetic character (delimiter) are not counted */
+void count_kwords(Kwordhist *hist, const char *seq, int kword_len, int base)
+{
+	int i, j, n;
+	int run = 0; /* number of consecutive code characters up to position 'i' */
+	int length = strlen(seq);
+	uint64_t code = 0;
+	uint64_t top = 1; /* value of the leading digit of a k-word */
+	uint64_t *codes;
+
+	for (i = 1; i < kword_len; ++ i)
+		top *= base;
+
+	/* codes of all k-words, by rolling the window along the sequence */
+	codes = safe_malloc((length + 1) * sizeof(uint64_t));
+	for (i = 0, n = 0; i < length; ++ i)
+	{
+		if (! isalpha(seq[i]))
+		{
+			run = 0;
+			code = 0;
+			continue;
+		}
+
+		if (run == kword_len)
+			code %= top; /* drop leading character */
+		else
+			++ run;
+		code = code * base + (seq[i] - 'A');
+
+		if (run == kword_len)
+			codes[n ++] = code;
+	}
+
+	/* collapse sorted codes to (code, count) pairs */
+	qsort(codes, n, sizeof(uint64_t), cmp_code);
+
+	hist->kword = safe_malloc((n + 1) * sizeof(Kword));
+	hist->n_kword = 0;
+	hist->n_all = n;
+
+	for (i = 0; i < n; i = j)
+	{
+		for (j = i + 1; j < n && codes[j] == codes[i]; ++ j)
+			;
+		hist->kword[hist->n_kword].code = codes[i];
+		hist->kword[hist->n_kword].count = j - i;
+		++ hist->n_kword;
+	}
+
+	free(codes);
+}
+
+/*____________________________________________________________________________*/
+void free_kwordhist(Kwordhist *hist)
+{
+	free(hist->kword);
+	hist->kword = 0;
+	hist->n_kword = 0;
+	hist->n_all = 0;
+}
+
+/*____________________________________________________________________________*/
+/* allocate 'size' empty slots */
+static void alloc_kwordtable(Kwordtable *table, int size)
+{
+	int i;
+
+	table->code = safe_malloc(size * sizeof(uint64_t));
+	table->count = safe_malloc(size * sizeof(int));
+	table->used = safe_malloc(size * sizeof(int));
+	for (i = 0; i < size; ++ i)
+		table->code[i] = KWORD_EMPTY;
+	table->size = size;
+	table->n_used = 0;
+}
+
+/*____________________________________________________________________________*/
+void init_kwordtable(Kwordtable *table)
+{
+	alloc_kwordtable(table, 1024);
+	table->n_all = 0;
+}
+
+/*____________________________________________________________________________*/
+/* empty the table in O(distinct k-words), keeping its memory */
+void clear_kwordtable(Kwordtable *table)
+{
+	int i;
+
+	for (i = 0; i < table->n_used; ++ i)
+		table->code[table->used[i]] = KWORD_EMPTY;
+
+	table->n_used = 0;
+	table->n_all = 0;
+}
+
+/*____________________________________________________________________________*/
+/* slot of 'code': either the slot holding it or the empty slot to put it in */
+static int find_slot(Kwordtable *table, uint64_t code)
+{
+	int slot = (int)((code * 0x9E3779B97F4A7C15ULL) >> 40) & (table->size - 1);
+
+	while (table->code[slot] != KWORD_EMPTY && table->code[slot] != code)
+		slot = (slot + 1) & (table->size - 1);
+
+	return slot;
+}
+
+/*____________________________________________________________________________*/
+/* double the number of slots, keeping the insertion order of k-words */
+static void grow_kwordtable(Kwordtable *table)
+{
+	int i, slot;
+	Kwordtable old = *table;
+
+	alloc_kwordtable(table, 2 * old.size);
+
+	for (i = 0; i < old.n_used; ++ i)
+	{
+		slot = find_slot(table, old.code[old.used[i]]);
+		table->code[slot] = old.code[old.used[i]];
+		table->count[slot] = old.count[old.used[i]];
+		table->used[table->n_used ++] = slot;
+	}
+
+	free(old.code);
+	free(old.count);
+	free(old.used);
+}
+
+/*____________________________________________________________________________*/
+/* add ('sign' = 1) or subtract ('sign' = -1) the k-word counts of a histogram */
+/* k-words stay in the table when their count drops to zero */
+void add_kwordhist(Kwordtable *table, Kwordhist *hist, int sign)
+{
+	int i, slot;
+
+	for (i = 0; i < hist->n_kword; ++ i)
+	{
+		/* keep the load factor below 1/2 */
+		if (2 * (table->n_used + 1) > table->size)
+			grow_kwordtable(table);
+
+		slot = find_slot(table, hist->kword[i].code);
+		if (table->code[slot] == KWORD_EMPTY)
+		{
+			table->code[slot] = hist->kword[i].code;
+			table->count[slot] = 0;
+			table->used[table->n_used ++] = slot;
+		}
+		table->count[slot] += sign * hist->kword[i].count;
+	}
+
+	table->n_all += sign * hist->n_all;
+}
+
+/*____________________________________________________________________________*/
+/* count of k-word 'code' in the table */
+int kwordtable_count(Kwordtable *table, uint64_t code)
+{
+	int slot = find_slot(table, code);
+
+	return (table->code[slot] == KWORD_EMPTY ? 0 : table->count[slot]);
+}
+
+/*____________________________________________________________________________*/
+/* count * log2(count) in fixed point: sums of these terms are exact, */
+/* therefore independent of the order in which counts are added up */
+int64_t kword_xlogx(int count)
+{
+	if (count < 2)
+		return 0;
+
+	return llround(count * log2(count) * KWORD_XLOGX_SCALE);
+}
+
+/*____________________________________________________________________________*/
+/* sum of 'kword_xlogx' over all k-words in the table */
+int64_t kwordtable_xlogx(Kwordtable *table)
+{
+	int i;
+	int64_t xlogx = 0;
+
+	for (i = 0; i < table->n_used; ++ i)
+		xlogx += kword_xlogx(table->count[table->used[i]]);
+
+	return xlogx;
+}
+
+/*____________________________________________________________________________*/
+/* Shannon entropy (bits) of 'n_all' k-words with counts c_i, from the sum of */
+/* c_i * log2(c_i): H = log2(n_all) - sum(c_i * log2(c_i)) / n_all */
+float kword_entropy(int64_t xlogx, int n_all)
+{
+	if (n_all == 0)
+		return 0.;
+
+	return (float)(log2(n_all) - xlogx / KWORD_XLOGX_SCALE / n_all);
+}
+
+/*____________________________________________________________________________*/
+/* Shannon entropy (bits) of the k-word distribution in the table */
+float kwordtable_entropy(Kwordtable *table)
+{
+	return kword_entropy(kwordtable_xlogx(table), table->n_all);
+}
+
+/*____________________________________________________________________________*/
+void free_kwordtable(Kwordtable *table)
+{
+	free(table->code);
+	free(table->count);
+	free(table->used);
+}
+
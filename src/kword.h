@@ -0,0 +1,80 @@
+/*==============================================================================
+kword.h : k-word (fixed-length substring) counts of sequences
+(C) 2006-2017 Jens Kleinjung
+(C) 2006-2007 Alessandro Pandini
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+==============================================================================*/
+
+#if !defined(KWORD_H)
+#define KWORD_H
+
+/*____________________________________________________________________________*/
+/* includes */
+#include <stdint.h>
+
+/*____________________________________________________________________________*/
+/* defines */
+
+/* code of empty hash table slots, larger than any k-word code */
+#define KWORD_EMPTY UINT64_MAX
+/* fixed-point scale of count * log2(count) terms */
+#define KWORD_XLOGX_SCALE 1048576.
+
+/*____________________________________________________________________________*/
+/* structures */
+
+/* k-word encoded as integer: character ranks (character - 'A') are the digits
+	of a number with base 'alphabet.size' */
+typedef struct
+{
+	uint64_t code; /* rank-encoded k-word */
+	int count; /* number of occurrences */
+} Kword;
+
+/* sparse k-word histogram of a sequence, sorted by code */
+typedef struct
+{
+	Kword *kword; /* distinct k-words and their counts */
+	int n_kword; /* number of distinct k-words */
+	int n_all; /* total number of k-words */
+} Kwordhist;
+
+/* k-word counts of a subset: open-addressing hash table keyed by code */
+typedef struct
+{
+	uint64_t *code; /* k-word codes */
+	int *count; /* k-word counts */
+	int *used; /* occupied slots in order of insertion */
+	int n_used; /* number of occupied slots = distinct k-words */
+	int size; /* number of slots (power of 2) */
+	int n_all; /* total number of k-words */
+} Kwordtable;
+
+/*____________________________________________________________________________*/
+/* prototypes */
+int kword_fits(int kword_len, int base);
+void count_kwords(Kwordhist *hist, const char *seq, int kword_len, int base);
+void free_kwordhist(Kwordhist *hist);
+void init_kwordtable(Kwordtable *table);
+void clear_kwordtable(Kwordtable *table);
+void add_kwordhist(Kwordtable *table, Kwordhist *hist, int sign);
+int kwordtable_count(Kwordtable *table, uint64_t code);
+int64_t kword_xlogx(int count);
+int64_t kwordtable_xlogx(Kwordtable *table);
+float kword_entropy(int64_t xlogx, int n_all);
+float kwordtable_entropy(Kwordtable *table);
+void free_kwordtable(Kwordtable *table);
+
+#endif
@@ -28,7 +28,9 @@ License:
 =============================================================================*/
 
 #include "alphabet.h"
+#include "corpus.h"
 #include "getseqs.h"
+#include "kword.h"
 #include "parse_args.h"
 #include "suffix_tree.h"
 #include "minset.h"
@@ -96,7 +98,7 @@ float relative_entropy(float *p, float *q, int length)
 /*____________________________________________________________________________-*/  
 /* word entropy from suffix tree: */
 /* the entropy of the subset based on a constant-length word alphabet */
-float word_entropy(char *ref_string, char *search_string, int *p_nsymbols, int *p_kword_len)
+float word_entropy(char *ref_string, char *search_string, int *p_nsymbols, int *p_kword_len, NODE_ARENA *arena)
 {
     SUFFIX_TREE* tree; /* the suffix tree */
     DBL_WORD ref_len = 0; /* length of reference string */
@@ -119,7 +121,7 @@ float word_entropy(char *ref_string, char *search_string, int *p_nsymbols, int *
 	assert(search_len <= ref_len);
 	assert(sub_len <= search_len);
 
-    tree = ST_CreateTree(ref_string, ref_len); /* generate the suffix tree */
+    tree = ST_CreateTreeInArena(ref_string, ref_len, arena); /* generate the suffix tree */
     ST_InitTreeHits(tree);
 
     /* for the length of the search string */
@@ -138,7 +140,7 @@ float word_entropy(char *ref_string, char *search_string, int *p_nsymbols, int *
         ++ n_all; /* count all subSetSequences */
 
         /* search substring in suffix tree */
-        //position = ST_FindSubstring(tree, sub_pc, sub_len);
+        ST_FindSubstring(tree, sub_pc, sub_len);
 
         ++ i; /* increment pointer position */
     }
@@ -148,7 +150,7 @@ float word_entropy(char *ref_string, char *search_string, int *p_nsymbols, int *
     entropy = ST_TreeEntropy(tree);
     *p_nsymbols = tree->allsymbol; 
 
-    ST_DeleteTree(tree);
+    ST_DeleteTree(tree); /* the nodes stay in the arena for the next tree */
 
     return entropy;
 }
@@ -196,23 +198,69 @@ float score_compress(char *instring, int insize, int total_len)
     return zipscore;
 }
 
+/*____________________________________________________________________________*/
+/* read all records of the multi-record FASTA file 'basesetFileName'; */
+/* protein names are the first words of the header lines */
+static void read_fastaset(Minset *ms)
+{
+	Seqfile sf;
+	ProteinEntry *protein;
+	size_t i;
+	int k = 0;
+	int allocated = 64;
+
+	ms->prots.protein = safe_malloc(allocated * sizeof(ProteinEntry));
+
+	open_seqfile(&sf, ms->basesetFileName);
+	while (read_sequence(&sf, &ms->prots, k))
+	{
+		protein = &ms->prots.protein[k];
+		for (i = 1; protein->description[i] != '\0' && ! isspace(protein->description[i]); ++ i)
+			;
+		protein->name = safe_malloc(i * sizeof(char));
+		memcpy(protein->name, &protein->description[1], i - 1);
+		protein->name[i - 1] = '\0';
+
+		if (++ k == allocated)
+		{
+			allocated += 64;
+			ms->prots.protein = safe_realloc(ms->prots.protein, allocated * sizeof(ProteinEntry));
+		}
+	}
+	close_seqfile(&sf);
+
+	ms->prots.n_prot = k;
+	ms->prots.fasta = 1;
+}
+
 /*____________________________________________________________________________-*/  
 /* parse the protein list file 
-	the format is simply a list of filenames */
+	the format is simply a list of filenames,
+	or a multi-record FASTA file holding all sequences */
 void parse_proteinlist(Minset *ms)
 {
     FILE *listfile;
     char line[256];
+    char first;
     unsigned int i;
     unsigned int k = 0;
     int allocated = 64;
 
+    listfile = safe_open(ms->basesetFileName, "r");
+
+	/* a FASTA file starts with a header line */
+	if (fscanf(listfile, " %c", &first) == 1 && first == '>')
+	{
+		fclose(listfile);
+		read_fastaset(ms);
+		return;
+	}
+	rewind(listfile);
+
 	/*____________________________________________________________________________-*/  
     /* record the protein names in 'prots' array */
     ms->prots.protein = safe_malloc(allocated * sizeof(ProteinEntry));
 
-    listfile = safe_open(ms->basesetFileName, "r");
-
     while (fgets(line, 256, listfile))
     { 
 		ms->prots.protein[k].name = safe_malloc(256 * sizeof(char));
@@ -238,36 +286,25 @@ void parse_proteinlist(Minset *ms)
 }
 
 /*____________________________________________________________________________*/
-/* score the concatenated sequence */
-float score_seq(Minset *ms, char *subSetSeq)
+/* score a sequence by its k-word entropy 'H' and code character counts */
+/* 'length' is the sequence length including delimiters */
+float score_counts(Minset *ms, float H, int *charCount, int length)
 {
     int i;
-    int strlengthSub;
-	int n_symbol; /* number of k-word alphabet symbols (k-words) */
-    float H = 0.; /* entropy */
     float E = 0.; /* expected entropy */
     float D = 0.; /* relative entropy */
     float score = 0.; /* fitness score */
-    int charCount[ms->alphabet.size];
-    float *p_count; /* relative frequency of chode character */
-    float *p_bg; /* same for background distribution */
-
-    p_count = safe_malloc(sizeof(float) * ms->alphabet.size);
-    p_bg = safe_malloc(sizeof(float) * ms->alphabet.size);
-
-    strlengthSub = strlen(subSetSeq); /* count before moving the seq pointer on*/
-
-    get_counts(subSetSeq, charCount, ms->alphabet.size);
+    float p_count[ms->alphabet.size]; /* relative frequency of chode character */
+    float p_bg[ms->alphabet.size]; /* same for background distribution */
 
     for (i = 0; i < ms->alphabet.size; ++ i)
 	{
-        p_count[i] = charCount[i] / (float) strlengthSub; /* foregrund frequencies */
+        p_count[i] = charCount[i] / (float) length; /* foregrund frequencies */
         p_bg[i] = ms->alphabet.freq[i]; /* background frequencies */
 	}
 
     /*H = shannon_entropy(p_count, alphabet_array_len);*/ /* single-character alphabet */
 
-    H = word_entropy(subSetSeq, subSetSeq, &n_symbol, &ms->kword_len); /* contant-length word alphabet */
     E = shannon_entropy(p_bg, ms->alphabet.size);
     D = relative_entropy(p_count, p_bg, ms->alphabet.size);
 
@@ -275,115 +312,351 @@ float score_seq(Minset *ms, char *subSetSeq)
 
 #ifdef DEBUG
     fprintf(stderr, "l: %d, H: %f, E: %f, D: %f, score: %f\n",
-            strlengthSub, H, E, D, score);
+            length, H, E, D, score);
 #endif
 
-    free(p_count);
-    free(p_bg);
-
     return score;
 }
 
+/*____________________________________________________________________________*/
+/* score the concatenated sequence, k-word entropy from its suffix tree */
+float score_seq(Minset *ms, Workspace *ws, char *subSetSeq)
+{
+	int n_symbol; /* number of k-word alphabet symbols (k-words) */
+    float H = 0.; /* entropy */
+    int charCount[ms->alphabet.size];
+
+    get_counts(subSetSeq, charCount, ms->alphabet.size);
+
+    H = word_entropy(subSetSeq, subSetSeq, &n_symbol, &ms->kword_len, ws->arena); /* contant-length word alphabet */
+
+    return score_counts(ms, H, charCount, strlen(subSetSeq));
+}
+
+/*____________________________________________________________________________*/
+/* add up the precomputed counts of a set of proteins, return the length */
+/* of the proteins concatenated with delimiters, as in 'calculate_fitness' */
+static int sum_proteins(Minset *ms, Kwordtable *kwords, int *charCount, int *select, int n_select)
+{
+	int i, j;
+	int length = 0;
+	ProteinEntry *protein;
+
+	clear_kwordtable(kwords);
+	memset(charCount, 0, ms->alphabet.size * sizeof(int));
+
+	for (i = 0; i < n_select; ++ i)
+	{
+		protein = &ms->prots.protein[select[i]];
+		add_kwordhist(kwords, &protein->kwords, 1);
+		for (j = 0; j < ms->alphabet.size; ++ j)
+			charCount[j] += protein->charCount[j];
+		length += protein->length + 1; /* sequence plus delimiter */
+	}
+
+	return length;
+}
+
+/*____________________________________________________________________________*/
+/* score a set of proteins, k-word entropy from their precomputed k-word counts */
+float score_proteins(Minset *ms, Workspace *ws, int *select, int n_select)
+{
+	int length = sum_proteins(ms, &ws->kwords, ws->charCount, select, n_select);
+
+	if (length == 0)
+		return 0.;
+
+	return score_counts(ms, kwordtable_entropy(&ws->kwords), ws->charCount, length);
+}
+
+/*____________________________________________________________________________*/
+/* score a genome from the counts of a similar parent genome: */
+/* only the counts of proteins that differ from the parent are added or subtracted */
+/* and only the entropy terms of the affected k-words are updated */
+float score_delta(Minset *ms, Workspace *ws, Parent *parent, uint64_t *bitgenome, Fold *fold)
+{
+	int i, j;
+	int sign;
+	uint64_t diff; /* genes that differ from the parent */
+	int length = parent->length;
+	int count, delta;
+	int64_t xlogx = parent->xlogx;
+	ProteinEntry *protein;
+
+	/* k-word count changes relative to the parent */
+	clear_kwordtable(&ws->kwords);
+	memcpy(ws->charCount, parent->charCount, ms->alphabet.size * sizeof(int));
+
+	for (i = 0; i < BITWORDS(fold->n_prot); ++ i)
+	{
+		for (diff = bitgenome[i] ^ parent->bitgenome[i]; diff != 0; diff &= diff - 1)
+		{
+			protein = &ms->prots.protein[fold->protein[i * BITWORD + __builtin_ctzll(diff)]];
+			sign = ((bitgenome[i] & diff & -diff) ? 1 : -1);
+			add_kwordhist(&ws->kwords, &protein->kwords, sign);
+			for (j = 0; j < ms->alphabet.size; ++ j)
+				ws->charCount[j] += sign * protein->charCount[j];
+			length += sign * (protein->length + 1);
+		}
+	}
+
+	if (length == 0)
+		return 0.;
+
+	/* replace the entropy terms of changed k-words */
+	for (i = 0; i < ws->kwords.n_used; ++ i)
+	{
+		delta = ws->kwords.count[ws->kwords.used[i]];
+		if (delta == 0)
+			continue;
+
+		count = kwordtable_count(&parent->kwords, ws->kwords.code[ws->kwords.used[i]]);
+		xlogx += kword_xlogx(count + delta) - kword_xlogx(count);
+	}
+
+	return score_counts(ms, kword_entropy(xlogx, parent->kwords.n_all + ws->kwords.n_all),
+		ws->charCount, length);
+}
+
+/*____________________________________________________________________________*/
+/* protein table indices of the selected proteins, returns their number */
+static int select_proteins(uint64_t *bitgenome, Fold *fold, int *select)
+{
+	int i;
+	int n_select = 0;
+	uint64_t word;
+
+	for (i = 0; i < BITWORDS(fold->n_prot); ++ i)
+		for (word = bitgenome[i]; word != 0; word &= word - 1)
+			select[n_select ++] = fold->protein[i * BITWORD + __builtin_ctzll(word)];
+
+	return n_select;
+}
+
+#if !defined(COMPRESS_SCORE) && !defined(SUFFIX_TREE_SCORE)
+/*____________________________________________________________________________*/
+/* parent genome closest to 'genome', if scoring from its counts is cheaper */
+/* than summing up the 'n_select' selected proteins */
+static Parent *closest_parent(Minset *ms, Parent *parent, uint64_t *bitgenome, int genenum, int n_select)
+{
+	int i, j;
+	int dist;
+	int min_dist = (n_select + 1) / 2; /* larger distances are scored from scratch */
+	Parent *closest = 0;
+
+	for (i = 0; i < ms->n_parent; ++ i)
+	{
+		if (parent[i].bitgenome == 0)
+			continue;
+
+		/* Hamming distance, abandoned once it exceeds the best distance */
+		for (j = 0, dist = 0; j < BITWORDS(genenum) && dist < min_dist; ++ j)
+			dist += __builtin_popcountll(bitgenome[j] ^ parent[i].bitgenome[j]);
+
+		if (dist < min_dist)
+		{
+			min_dist = dist;
+			closest = &parent[i];
+		}
+	}
+
+	return closest;
+}
+#endif
+
+/*____________________________________________________________________________*/
+/* base set loading, shared by the loader threads */
+typedef struct
+{
+	Minset *ms;
+	char **seq; /* sequence of each protein, read into its own buffer */
+} Loader;
+
+/*____________________________________________________________________________*/
+/* read the sequence file of protein 'k' into a buffer of its own */
+static void read_protein(void *arg, int k, int tid)
+{
+	Loader *ld = (Loader *)arg;
+	Minset *ms = ld->ms;
+	Prots own; /* one-protein table around protein 'k' */
+	Seqfile fastaFile; char *fastaFileName;
+
+	own.protein = &ms->prots.protein[k];
+	own.allocated = 256;
+	own.residues = safe_malloc(own.allocated);
+	own.n_residue = 0;
+
+	fastaFileName = safe_malloc(strlen(ms->seqdir) + strlen(ms->prots.protein[k].name) + 6);
+	sprintf(fastaFileName, "%s%s.tseq", ms->seqdir, ms->prots.protein[k].name);
+	open_seqfile(&fastaFile, fastaFileName);
+	if (! read_sequence(&fastaFile, &own, 0))
+	{
+		fprintf(stderr, "Exiting: no FASTA sequence in file %s\n", fastaFileName);
+		exit(1);
+	}
+	close_seqfile(&fastaFile);
+	free(fastaFileName);
+
+	ld->seq[k] = own.residues;
+}
+
+/*____________________________________________________________________________*/
+/* precompute counts and entropy of protein 'k', using workspace 'tid' */
+static void precompute_protein(void *arg, int k, int tid)
+{
+	Minset *ms = (Minset *)arg;
+	ProteinEntry *protein = &ms->prots.protein[k];
+
+	/* code character counts and k-word counts of this sequence */
+	protein->charCount = safe_malloc(ms->alphabet.size * sizeof(int));
+	get_counts(protein->seq, protein->charCount, ms->alphabet.size);
+	count_kwords(&protein->kwords, protein->seq, ms->kword_len, ms->alphabet.size);
+
+	/* entropy of this sequence */
+#if !defined(COMPRESS_SCORE) && !defined(SUFFIX_TREE_SCORE)
+	clear_kwordtable(&ms->workspace[tid].kwords);
+	add_kwordhist(&ms->workspace[tid].kwords, &protein->kwords, 1);
+	protein->entropy = score_counts(ms, kwordtable_entropy(&ms->workspace[tid].kwords),
+		protein->charCount, protein->length);
+#endif
+#ifdef SUFFIX_TREE_SCORE
+	protein->entropy = score_seq(ms, &ms->workspace[tid], protein->seq);
+#endif
+#ifdef COMPRESS_SCORE
+	protein->entropy = score_compress(protein->seq, strlen(protein->seq));
+#endif
+}
+
 /*____________________________________________________________________________*/
 /* fill protein table with sequences and their entropies */
+/* sequence files are read and proteins precomputed by one thread per workspace; */
+/* the table is assembled in base set order, independent of the number of threads */
 void fill_protein_table(Minset *ms)
 {
 	unsigned int k;
-	FILE *fastaFile; char *fastaFileName;
+	size_t n_residue;
+	Loader loader;
 	FILE *setFile;
 
 	/* initialise counters */
 	ms->total_len = 0;
 
+	if (! kword_fits(ms->kword_len, ms->alphabet.size))
+	{
+		fprintf(stderr, "Exiting: k-word length %d too large for alphabet '%s'\n",
+			ms->kword_len, ms->alphabet.name);
+		exit(1);
+	}
+
 	ms->setfasta_charCount = safe_malloc(ms->alphabet.size * sizeof(int));
 
 	/*____________________________________________________________________________*/
-	/* read all FASTA sequences */
+	/* read all FASTA sequences, unless mapped from a corpus file or read with */
+	/* the base set, then append them to one buffer in base set order */
+	if (ms->corpus == 0 && ! ms->prots.fasta)
+	{
+		loader.ms = ms;
+		loader.seq = safe_malloc(ms->prots.n_prot * sizeof(char *));
+		run_parallel(ms->n_workspace, ms->prots.n_prot, read_protein, &loader);
+
+		for (k = 0, n_residue = ms->prots.n_residue; k < ms->prots.n_prot; ++ k)
+			n_residue += ms->prots.protein[k].length + 1;
+		if (n_residue > ms->prots.allocated)
+		{
+			ms->prots.residues = safe_realloc(ms->prots.residues, n_residue);
+			ms->prots.allocated = n_residue;
+		}
+
+		for (k = 0; k < ms->prots.n_prot; ++ k)
+		{
+			ms->prots.protein[k].offset = ms->prots.n_residue;
+			memcpy(&ms->prots.residues[ms->prots.n_residue], loader.seq[k], ms->prots.protein[k].length + 1);
+			ms->prots.n_residue += ms->prots.protein[k].length + 1;
+			free(loader.seq[k]);
+		}
+		free(loader.seq);
+	}
+
+	/* the buffer is complete: trim it and point to the sequences */
+	if (ms->corpus == 0 && ms->prots.n_residue > 0)
+	{
+		ms->prots.residues = safe_realloc(ms->prots.residues, ms->prots.n_residue);
+		ms->prots.allocated = ms->prots.n_residue;
+	}
+    for (k = 0; k < ms->prots.n_prot && ms->corpus == 0; ++ k)
+		ms->prots.protein[k].seq = &ms->prots.residues[ms->prots.protein[k].offset];
+
+	/*____________________________________________________________________________*/
+	/* precompute counts and entropy of each sequence, unless taken from a corpus file */
+	if (! ms->prots.precomputed)
+		run_parallel(ms->n_workspace, ms->prots.n_prot, precompute_protein, ms);
+
     for (k = 0; k < ms->prots.n_prot; ++ k)
     {
-		/* read sequence 'k' */
-        fastaFileName = safe_malloc(strlen(ms->seqdir) + strlen(ms->prots.protein[k].name) + 6);
-		strcpy(fastaFileName, "");
-        sprintf(fastaFileName, "%s%s.tseq", ms->seqdir, ms->prots.protein[k].name);
-	/*fprintf(stdout, "Reading sequence: %s\n", fastaFileName);*/
-	fastaFile = safe_open(fastaFileName, "r");
-        read_sequence(fastaFile, &(ms->prots), k);
-        fclose(fastaFile);
-		free(fastaFileName);
-
 		/* add code character frequencies of this sequence to overall count */
         get_counts(ms->prots.protein[k].seq, &ms->setfasta_charCount[0], ms->alphabet.size);
 
 		/* add length of this sequence to overall length */
-        ms->total_len += strlen(ms->prots.protein[k].seq);
-
-		/* compute the entropy of this sequence */
-#ifndef COMPRESS_SCORE
-        ms->prots.protein[k].entropy = score_seq(ms, ms->prots.protein[k].seq);
-#endif
-#ifdef COMPRESS_SCORE
-        ms->prots.protein[k].entropy = score_compress(ms->prots.protein[k].seq, strlen(ms->prots.protein[k].seq));
-#endif
+        ms->total_len += ms->prots.protein[k].length;
     }
 
 	/*____________________________________________________________________________*/
-	/* concatenate all base set sequences to 'setfasta' with '-' delimiter */
-    ms->setfasta = safe_malloc((ms->total_len + ms->prots.n_prot + 1) * sizeof(char));
-    strcpy(ms->setfasta, ms->prots.protein[0].seq);
-    for (k = 1; k < ms->prots.n_prot; ++ k)
+	/* print all base set sequences concatenated with '-' delimiter */
+    setFile = safe_open("baseset.seq", "w");
+    for (k = 0; k < ms->prots.n_prot; ++ k)
     {
-        strcat(ms->setfasta, "-");
-        strcat(ms->setfasta, ms->prots.protein[k].seq);
+		if (k > 0)
+			fputc('-', setFile);
+		fwrite(ms->prots.protein[k].seq, sizeof(char), ms->prots.protein[k].length, setFile);
     }
-
-	/*____________________________________________________________________________*/
-	/* print concatenated 'setfasta' sequence */
-    setFile = safe_open("baseset.seq", "w");
-	fprintf(setFile, "%s", ms->setfasta);
 	fclose(setFile);
 
 	free(ms->setfasta_charCount);
-	free(ms->setfasta);
 }
 
 /*____________________________________________________________________________*/
-/* calculate fitness of (concatenated) selected protein sequences */
-float calculate_fitness(Pool *pool, Gapar *gaPar, int ix, Minset *ms)
+/* calculate fitness of (concatenated) selected protein sequences of jackknife fraction 'fold' */
+float calculate_fitness(Pool *pool, Gapar *gaPar, int ix, Minset *ms, Fold *fold, Workspace *ws, Parent *parents)
 {
+#if defined(COMPRESS_SCORE) || defined(SUFFIX_TREE_SCORE)
     int i;
-    int allocated = 1;
-
-    ms->polyfasta = safe_malloc(allocated);
-    strcpy(ms->polyfasta, "");
-
-    for (i = 0; i < gaPar->genenum; ++ i)
+	int n_select = select_proteins(pool_bitgenome(pool, ix), fold, ws->select);
+	int length = 0;
+	char *polyfasta = ws->subset; /* subset string, owned by the calling thread */
+	ProteinEntry *protein;
+
+	/* concatenate the selected proteins with '-' delimiters: */
+	/* the workspace holds the whole base set, lengths are known */
+    for (i = 0; i < n_select; ++ i)
     {
-        if (pool[ix].genome[i] == 1)
-        {
-			allocated += strlen(ms->prots.protein[i].seq) + 1;
-			ms->polyfasta = safe_realloc(ms->polyfasta, allocated * sizeof(char));
-			strcat(ms->polyfasta, ms->prots.protein[i].seq);
-			strcat(ms->polyfasta, "-");
-        }
+		protein = &ms->prots.protein[ws->select[i]];
+		memcpy(&polyfasta[length], protein->seq, protein->length);
+		length += protein->length;
+		polyfasta[length ++] = '-';
     }
+	polyfasta[length] = '\0';
 
-#ifndef COMPRESS_SCORE
-    pool[ix].fitness = score_seq(ms, ms->polyfasta);
+#ifdef SUFFIX_TREE_SCORE
+    pool->fitness[ix] = score_seq(ms, ws, polyfasta);
 #endif
 #ifdef COMPRESS_SCORE
-    pool[ix].fitness = score_compress(ms->polyfasta, strlen(ms->polyfasta), ms->total_len);
+    pool->fitness[ix] = score_compress(polyfasta, length, ms->total_len);
 #endif
 #ifdef DEBUG
-	dump2(ms->polyfasta, "%s", pool[ix].fitness, "%f");
+	dump2(polyfasta, "%s", pool->fitness[ix], "%f");
+#endif
+#else
+	int n_select = select_proteins(pool_bitgenome(pool, ix), fold, ws->select);
+	Parent *parent;
+
+	/* update the counts of a similar parent or sum up the counts of the selected proteins */
+	if ((parent = closest_parent(ms, parents, pool_bitgenome(pool, ix), gaPar->genenum, n_select)) != 0)
+		pool->fitness[ix] = score_delta(ms, ws, parent, pool_bitgenome(pool, ix), fold);
+	else
+		pool->fitness[ix] = score_proteins(ms, ws, ws->select, n_select);
 #endif
 
-	ms->polyfasta_charCount = safe_malloc(ms->alphabet.size * sizeof(int));
-    get_counts(ms->polyfasta, ms->polyfasta_charCount, ms->alphabet.size);
-
-	free(ms->polyfasta);
-	free(ms->polyfasta_charCount);
-
-	return pool[ix].fitness;
+	return pool->fitness[ix];
 }
 
 /*____________________________________________________________________________*/
@@ -435,6 +708,8 @@ void parametrise_minset(Minset *ms)
 {
 	strcpy(ms->basesetFileName, BASESET); assert (strlen(ms->basesetFileName) > 1);
 	strcpy(ms->seqdir, SEQDIR); assert (strlen(ms->seqdir) > 1);
+	strcpy(ms->corpusFileName, CORPUS);
+	strcpy(ms->packFileName, PACK);
 	strcpy(ms->alphabet.name, ALPHABET); assert (strlen(ms->alphabet.name) > 1);
 	ms->subsetsize = (float)SUBSETSIZE; assert (ms->subsetsize > 0 && ms->subsetsize <= 100);
 	ms->kword_len = (int)KWORDLENGTH; assert (ms->kword_len > 0);
@@ -442,30 +717,46 @@ void parametrise_minset(Minset *ms)
 
 /*____________________________________________________________________________*/
 /* print subset composition and string */
-void print_subset(Pool *pool, Gapar *gaPar, Minset *ms)
+void print_subset(Pool *pool, Gapar *gaPar, Minset *ms, int r, int f)
 {
 	unsigned int i, j;
+	ProteinEntry *protein;
 	/*unsigned int k;*/
-	FILE *subsetSeqFile;
+	char subsetListFileName[64], subsetSeqFileName[64];
+	FILE *subsetListFile, *subsetSeqFile;
+
+	/* subset files of repeat 'r' and jackknife fraction 'f', plain names for a single run */
+	if (gaPar->repeat * gaPar->jackknife == 1)
+	{
+		strcpy(subsetListFileName, "subset.list");
+		strcpy(subsetSeqFileName, "subset.seq");
+	}
+	else
+	{
+		sprintf(subsetListFileName, "subset.%d_%d.%d_%d.list", r, gaPar->repeat - 1, f, gaPar->jackknife - 1);
+		sprintf(subsetSeqFileName, "subset.%d_%d.%d_%d.seq", r, gaPar->repeat - 1, f, gaPar->jackknife - 1);
+	}
 
-    subsetSeqFile = safe_open("subset.seq", "w");
+    subsetListFile = safe_open(subsetListFileName, "w");
+    subsetSeqFile = safe_open(subsetSeqFileName, "w");
 
 	/* print table: protein names and gene values of fittest genomes */
 	for (j = 0; j < gaPar->genenum; ++ j)
 	{
 		/* sequence of protein names is identical to gene sequence */
 		/* and print concatenated subset sequences delimited with '+' */
-		fprintf(ms->subsetOutFile, "%7s ", ms->prots.protein[j].name);
+		protein = &ms->prots.protein[ms->fold[f].protein[j]];
+		fprintf(subsetListFile, "%7s ", protein->name);
 
 		for (i = 0; i < gaPar->fitmate; ++ i)
 		{
-			fprintf(ms->subsetOutFile, " %1d", pool[i].genome[j]);
+			fprintf(subsetListFile, " %1d", get_bitgene(pool_bitgenome(pool, i), j));
 
-			if (i == 0 && pool[i].genome[j] == 1)
-				fprintf(subsetSeqFile, "%s+", ms->prots.protein[j].seq);
+			if (i == 0 && get_bitgene(pool_bitgenome(pool, i), j))
+				fprintf(subsetSeqFile, "%s+", protein->seq);
 		}
 
-		fprintf(ms->subsetOutFile, "\n");
+		fprintf(subsetListFile, "\n");
 	}
 	
 	/*____________________________________________________________________________*/
@@ -475,52 +766,201 @@ void print_subset(Pool *pool, Gapar *gaPar, Minset *ms)
     strcpy(ms->subsetfasta, "");
     for (k = 0; k < ms->prots.n_prot; ++ k)
     {
-		if (pool[0].genome[k] != 0)
+		if (get_bitgene(pool_bitgenome(pool, 0), k))
 		{
 			strcat(ms->subsetfasta, ms->prots.protein[k].seq);
 			strcat(ms->subsetfasta, "+");
 		}
 	}
+	free(ms->subsetfasta);
 	*/
 	
+	fclose(subsetListFile);
 	fclose(subsetSeqFile);
-	free(ms->subsetfasta);
 }
 
 /*____________________________________________________________________________*/
 void initialise_minset(Pool *pool, Gapar *gaPar, Minset *ms)
 {
+	int i, k;
+
     /* set character frequencies of selected alphabet */
 	set_alphabet(&(ms->alphabet));
 
     /*____________________________________________________________________________*/
     /* read and process sequence input */
-	/* file containing the list of sequence filenames */
-	parse_proteinlist(ms);
+	/* file containing the list of sequence filenames, or the corpus file */
+	ms->corpus = 0;
+	ms->prots.precomputed = 0;
+	ms->prots.fasta = 0;
+	ms->prots.allocated = 4096;
+	ms->prots.residues = safe_malloc(ms->prots.allocated);
+	ms->prots.n_residue = 0;
+	if (strlen(ms->corpusFileName) > 0)
+	{
+		free(ms->prots.residues);
+		load_corpus(ms, ms->corpusFileName);
+	}
+	else
+		parse_proteinlist(ms);
+
+    /* one workspace per worker thread of each island of each concurrent run */
+	ms->n_workspace = gaPar->jobs * gaPar->islands * island_threads(gaPar);
+	ms->workspace = safe_malloc(ms->n_workspace * sizeof(Workspace));
+	for (i = 0; i < ms->n_workspace; ++ i)
+	{
+		ms->workspace[i].arena = ST_CreateArena();
+		init_kwordtable(&ms->workspace[i].kwords);
+		ms->workspace[i].charCount = safe_malloc(ms->alphabet.size * sizeof(int));
+		ms->workspace[i].select = safe_malloc(ms->prots.n_prot * sizeof(int));
+		ms->workspace[i].subset = 0;
+	}
+
+	/* counts of the fittest genomes of each island, filled in after the first selection */
+	ms->n_island = gaPar->jobs * gaPar->islands;
+	ms->n_parent = DELTA_PARENTS;
+	ms->parent = safe_malloc(ms->n_island * ms->n_parent * sizeof(Parent));
+	for (i = 0; i < ms->n_island * ms->n_parent; ++ i)
+	{
+		ms->parent[i].bitgenome = 0;
+		init_kwordtable(&ms->parent[i].kwords);
+		ms->parent[i].charCount = safe_malloc(ms->alphabet.size * sizeof(int));
+	}
 
 	/* read sequences, calculate entropy score per sequence */
 	/* compute overall code character counts and overall sequence length */
-	/* concatenate sequences to total 'setfasta' sequence */
+	/* print concatenated sequences to 'baseset.seq' */
 	fill_protein_table(ms);
 
+#if defined(COMPRESS_SCORE) || defined(SUFFIX_TREE_SCORE)
+	/* subset strings are assembled in the workspaces, at most the whole base set */
+	for (i = 0; i < ms->n_workspace; ++ i)
+		ms->workspace[i].subset = safe_malloc((ms->total_len + ms->prots.n_prot + 1) * sizeof(char));
+#endif
+
 	gaPar->genenum = ms->prots.n_prot; /* overwrite number of genes in GA */
 	/* set number of genes that are switched ON: to achieve subset target size */
 	ms->n_selected = (int)floorf(gaPar->genenum * ms->subsetsize / 100);
 	assert(ms->n_selected > 1);
 
-    /*____________________________________________________________________________*/
-	/* basic output file (name might be modified in 'run_minset') */
-	ms->subsetOutFileName = safe_malloc(13 * sizeof(char));
-	strcpy(ms->subsetOutFileName, "subset.list");
-	ms->subsetOutFile = safe_open(ms->subsetOutFileName, "w");
+	/* jackknife fractions: fraction 'k' leaves out every 'jackknife'-th protein, */
+	/* starting with protein 'k'; a single fraction holds all proteins */
+	ms->n_fold = gaPar->jackknife;
+	ms->fold = safe_malloc(ms->n_fold * sizeof(Fold));
+	for (k = 0; k < ms->n_fold; ++ k)
+	{
+		ms->fold[k].protein = safe_malloc(ms->prots.n_prot * sizeof(int));
+		ms->fold[k].n_prot = 0;
+		for (i = 0; i < ms->prots.n_prot; ++ i)
+			if (ms->n_fold == 1 || i % ms->n_fold != k)
+				ms->fold[k].protein[ms->fold[k].n_prot ++] = i;
+		ms->fold[k].n_selected = (int)floorf(ms->fold[k].n_prot * ms->subsetsize / 100);
+		if (ms->fold[k].n_selected < 2)
+		{
+			fprintf(stderr, "Exiting: jackknife fraction %d selects less than 2 proteins\n", k);
+			exit(1);
+		}
+	}
 }
 
 /*____________________________________________________________________________*/
 /* run minset */
-float run_minset(Pool *pool, Gapar *gaPar, Minset *ms, int j, int k, int l, int ix)
+float run_minset(Pool *pool, Gapar *gaPar, Minset *ms, int j, int k, int l, int ix, int island, int tid)
+{
+	/* compute fitness of genome 'ix' of jackknife fraction 'k' */
+	/* in the workspace of thread 'tid' of 'island' */ 
+	return calculate_fitness(pool, gaPar, ix, ms, &ms->fold[k],
+		&ms->workspace[island * island_threads(gaPar) + tid], &ms->parent[island * ms->n_parent]);
+}
+
+#if !defined(COMPRESS_SCORE) && !defined(SUFFIX_TREE_SCORE)
+/*____________________________________________________________________________*/
+/* count the subset of a parent genome, called by the worker threads */
+typedef struct
+{
+	Minset *ms;
+	Gapar *gaPar;
+	Parent **todo; /* parents to count */
+	Fold *fold; /* jackknife fraction */
+	int island; /* island of the parents */
+} Parentcount;
+
+static void count_parent(void *ppc, int i, int tid)
 {
-	/* compute fitness of genome 'ix' */ 
-	return calculate_fitness(&pool[0], gaPar, ix, ms);
+	Parentcount *pc = (Parentcount *)ppc;
+	Parent *parent = pc->todo[i];
+	Workspace *ws = &pc->ms->workspace[pc->island * island_threads(pc->gaPar) + tid];
+	int n_select = select_proteins(parent->bitgenome, pc->fold, ws->select);
+
+	parent->length = sum_proteins(pc->ms, &parent->kwords, parent->charCount, ws->select, n_select);
+	parent->xlogx = kwordtable_xlogx(&parent->kwords);
+}
+#endif
+
+/*____________________________________________________________________________*/
+/* update minset after selection: keep the counts of the fittest genomes */
+/* of 'island' as reference for the incremental scoring of their offspring */
+/* in jackknife fraction 'k' */
+void update_minset(Pool *pool, Gapar *gaPar, Minset *ms, int k, int island)
+{
+#if !defined(COMPRESS_SCORE) && !defined(SUFFIX_TREE_SCORE)
+	int i, j;
+	Parent *parent = &ms->parent[island * ms->n_parent];
+	int n_todo = 0;
+	int n_word = BITWORDS(gaPar->genenum);
+	int n_fit = (gaPar->fitmate < ms->n_parent ? gaPar->fitmate : ms->n_parent);
+	int keep[ms->n_parent]; /* parent matches one of the fittest genomes */
+	int found[n_fit]; /* fittest genome already is a parent */
+	Parent *todo[ms->n_parent];
+	Parentcount pc;
+
+	memset(keep, 0, ms->n_parent * sizeof(int));
+	memset(found, 0, n_fit * sizeof(int));
+
+	/* parents that are still among the fittest genomes */
+	for (i = 0; i < n_fit; ++ i)
+		for (j = 0; j < ms->n_parent && ! found[i]; ++ j)
+			if (! keep[j] && parent[j].bitgenome != 0 &&
+				memcmp(pool_bitgenome(pool, i), parent[j].bitgenome, n_word * sizeof(uint64_t)) == 0)
+				keep[j] = found[i] = 1;
+
+	/* replace the other parents by the new fittest genomes */
+	for (i = 0, j = 0; i < n_fit; ++ i)
+	{
+		if (found[i])
+			continue;
+
+		while (keep[j])
+			++ j;
+
+		if (parent[j].bitgenome == 0)
+			parent[j].bitgenome = safe_malloc(n_word * sizeof(uint64_t));
+		memcpy(parent[j].bitgenome, pool_bitgenome(pool, i), n_word * sizeof(uint64_t));
+		keep[j] = 1;
+		todo[n_todo ++] = &parent[j];
+	}
+
+	pc.ms = ms;
+	pc.gaPar = gaPar;
+	pc.todo = todo;
+	pc.fold = &ms->fold[k];
+	pc.island = island;
+	run_parallel(island_threads(gaPar), n_todo, count_parent, &pc);
+#endif
+}
+
+/*____________________________________________________________________________*/
+/* forget the parents of 'island' at the start of a GA run */
+void reset_minset(Minset *ms, int island)
+{
+	int i;
+	Parent *parent = &ms->parent[island * ms->n_parent];
+
+	for (i = 0; i < ms->n_parent; ++ i)
+	{
+		free(parent[i].bitgenome);
+		parent[i].bitgenome = 0;
+	}
 }
 
 /*____________________________________________________________________________*/
@@ -529,23 +969,54 @@ void finalise_minset(Minset *ms)
 {
 	unsigned int i;
 
-	/* close last output file */
-	fclose(ms->subsetOutFile);
-
 	/* alphabet */
 	free(ms->alphabet.codeOrder);
 	free(ms->alphabet.freq);
 
-	/* filenames */
-	free(ms->subsetOutFileName);
+	/* workspaces */
+	for (i = 0; i < ms->n_workspace; ++ i)
+	{
+		ST_DeleteArena(ms->workspace[i].arena);
+		free_kwordtable(&ms->workspace[i].kwords);
+		free(ms->workspace[i].charCount);
+		free(ms->workspace[i].select);
+		free(ms->workspace[i].subset);
+	}
+	free(ms->workspace);
+
+	/* parents */
+	for (i = 0; i < ms->n_island * ms->n_parent; ++ i)
+	{
+		free(ms->parent[i].bitgenome);
+		free_kwordtable(&ms->parent[i].kwords);
+		free(ms->parent[i].charCount);
+	}
+	free(ms->parent);
+
+	/* jackknife fractions */
+	for (i = 0; i < ms->n_fold; ++ i)
+		free(ms->fold[i].protein);
+	free(ms->fold);
 
-	/* protein set */
+	/* protein set; names, sequences and precomputed counts of a corpus file */
+	/* are part of the mapped file */
     for (i = 0; i < ms->prots.n_prot; ++ i)
     {
-        free(ms->prots.protein[i].name);
-        free(ms->prots.protein[i].description);
-        free(ms->prots.protein[i].seq);
+		if (ms->corpus == 0)
+		{
+			free(ms->prots.protein[i].name);
+			free(ms->prots.protein[i].description);
+		}
+		if (! ms->prots.precomputed)
+		{
+			free(ms->prots.protein[i].charCount);
+			free_kwordhist(&ms->prots.protein[i].kwords);
+		}
 	}
     free(ms->prots.protein);
+	if (ms->corpus == 0)
+		free(ms->prots.residues);
+	else
+		unload_corpus(ms);
 }
 
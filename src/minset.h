@@ -24,6 +24,14 @@ minset.h : program for database subsetting
 /* includes */
 #include "alphabet.h"
 #include "ga.h"
+#include "getseqs.h"
+#include "kword.h"
+#include "suffix_tree.h"
+
+/* proteins are selected by binary genes */
+#ifndef BIT
+#error "minset requires binary genes: define BIT in ga.h"
+#endif
 
 /*____________________________________________________________________________*/
 /* defines */
@@ -36,7 +44,11 @@ typedef struct
 {
     char *name; /* protein (file)name */
     char *description; /* description in header of fastafile */
-    char *seq; /* seq from fastafile */
+    char *seq; /* seq from fastafile, in 'prots.residues' */
+    size_t offset; /* offset of 'seq' in 'prots.residues' */
+    int length; /* sequence length */
+    int *charCount; /* counts of single-character code symbols */
+    Kwordhist kwords; /* k-word counts */
     float entropy; /* entropy */
     float score; /* score */
 } ProteinEntry;
@@ -46,14 +58,53 @@ typedef struct
 {
     ProteinEntry *protein; /* data for each protein */
     int n_prot; /*number of proteins */
+    char *residues; /* sequences of all proteins, each zero-terminated, read-only after reading */
+    size_t n_residue; /* used size of 'residues' */
+    size_t allocated; /* allocated size of 'residues' */
+    int precomputed; /* counts and entropies taken from a corpus file */
+    int fasta; /* sequences read with the base set from a multi-record FASTA file */
     float entropy_sum; /* sum of single protein entropy in aa code */
 } Prots;
 
+/*___________________________________________________________________________*/
+/* scratch space of one worker thread, reused between fitness evaluations */
+typedef struct
+{
+	NODE_ARENA *arena; /* suffix tree nodes and string */
+	Kwordtable kwords; /* k-word counts of the subset */
+	int *charCount; /* code character counts of the subset */
+	int *select; /* indices of selected proteins */
+	char *subset; /* subset string, sized for the whole base set */
+} Workspace;
+
+/*___________________________________________________________________________*/
+/* counts of one of the fittest genomes, reference for scoring its offspring */
+typedef struct
+{
+	uint64_t *bitgenome; /* copy of the genome, 0 if not yet assigned */
+	Kwordtable kwords; /* k-word counts of the subset */
+	int *charCount; /* code character counts of the subset */
+	int length; /* subset length, including delimiters */
+	int64_t xlogx; /* sum of count * log2(count) over all k-words, fixed point */
+} Parent;
+
+/*___________________________________________________________________________*/
+/* proteins of one jackknife fraction: gene 'i' selects protein 'protein[i]' */
+/* of the shared protein table */
+typedef struct
+{
+	int *protein; /* indices of the fraction's proteins in the protein table */
+	int n_prot; /* number of proteins = genes */
+	int n_selected; /* target number of selected proteins */
+} Fold;
+
 /*____________________________________________________________________________*/
 typedef struct 
 {
 	char basesetFileName[200]; /* input file: list of protein FASTA filenames */
 	char seqdir[200]; /* relative path to directory holding sequence files */
+	char corpusFileName[200]; /* input file: binary corpus of the base set, replaces 'basesetFileName' */
+	char packFileName[200]; /* output file: binary corpus of the base set */
 	Alphabet alphabet; /* code alphabets */
 	float subsetsize; /* target percentage of minset/baseset size */
 	int kword_len; /* selection k-word (substring) length */
@@ -63,27 +114,39 @@ typedef struct
 
     /*____________________________________________________________________________*/
 	Prots prots; /* list of proteins */
+	unsigned char *corpus; /* mapped corpus file, 0 if read from sequence files */
+	size_t corpus_size; /* size of the corpus file */
 
     /*____________________________________________________________________________*/
-	char *setfasta; /* string of all (concatenated) sequences of base set */
 	int *setfasta_charCount; /* array of counts of single-character code symbols */
-	char *polyfasta; /* string of subset of (concatenated) sequences */
-	int *polyfasta_charCount; /* array of counts of single-character code symbols */
 
 	float kl_distance; /* Kullback-Leibler distance */
 	int total_len; /* total string length of concatenated sequences */
 	int n_selected; /* number of selected proteins */
 
+	Fold *fold; /* proteins of each jackknife fraction */
+	int n_fold; /* number of jackknife fractions */
+
+	Workspace *workspace; /* one workspace per worker thread of each island of each run */
+	int n_workspace; /* number of workspaces */
+
+	Parent *parent; /* fittest genomes of each island for incremental scoring */
+	int n_parent; /* number of parents per island */
+	int n_island; /* number of islands of all concurrent runs */
+
 	char *subsetfasta; /* string of all (concatenated) sequences of subset */
-    FILE *subsetOutFile; char *subsetOutFileName; /* file containing subset information */
 } Minset;
 
 /*____________________________________________________________________________*/
 void initialise_minset(Pool *pool, Gapar *gapar, Minset *ms);
-float run_minset(Pool *pool, Gapar *gapar, Minset *ms, int j, int k, int l, int ix);
+float run_minset(Pool *pool, Gapar *gapar, Minset *ms, int j, int k, int l, int ix, int island, int tid);
+void update_minset(Pool *pool, Gapar *gapar, Minset *ms, int k, int island);
+void reset_minset(Minset *ms, int island);
 void finalise_minset(Minset *ms);
-int read_sequence(FILE *aafile, Prots *prots, int k);
+void open_seqfile(Seqfile *sf, const char *fileName);
+int read_sequence(Seqfile *sf, Prots *prots, int k);
+void close_seqfile(Seqfile *sf);
 void parametrise_minset(Minset *ms);
-void print_subset(Pool *pool, Gapar *gaPar, Minset *ms);
+void print_subset(Pool *pool, Gapar *gaPar, Minset *ms, int r, int f);
 
 #endif
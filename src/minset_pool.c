@@ -0,0 +1,100 @@
+/*==============================================================================
+minset_pool.c : print binary pool files
+(C) 2006-2017 Jens Kleinjung
+(C) 2006-2007 Alessandro Pandini
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+==============================================================================*/
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "poolfile.h"
+
+/*____________________________________________________________________________*/
+/* print file header and one line per frame */
+static void print_frames(Poolmap *pm)
+{
+	int i;
+	const Poolhead *head = pm->head;
+	const Poolframe *frame;
+
+	fprintf(stdout, "# genenum %d popsize %d fitmate %d islands %d frames %d seed %d"
+		" repeat %d jackknife %d\n",
+		head->genenum, head->popsize, head->fitmate, head->islands, head->frames,
+		head->seed, head->j, head->k);
+	fprintf(stdout, "# frame generation island genomes final fitness\n");
+
+	for (i = 0; i < head->n_frame; ++ i)
+	{
+		frame = pm->frame[i];
+		fprintf(stdout, "%d %d %d %d %d %6.4f\n", i, frame->generation, frame->island,
+			frame->n_genome, frame->final,
+			frame->n_genome > 0 ? poolframe_fitness(frame)[0] : 0.);
+	}
+}
+
+/*____________________________________________________________________________*/
+/* print genomes of frame 'i' in the format of the '.ga' output files */
+static void print_genomes(Poolmap *pm, int i)
+{
+	int ix, gene;
+	const Poolframe *frame;
+	const uint64_t *genome;
+
+	if (i < 0 || i >= pm->head->n_frame)
+	{
+		fprintf(stderr, "Exiting: frame %d not in range 0 to %d\n", i, pm->head->n_frame - 1);
+		exit(1);
+	}
+	frame = pm->frame[i];
+
+	fprintf(stdout, "#%d\n", frame->generation);
+	for (ix = 0; ix < frame->n_genome; ++ ix)
+	{
+		genome = poolframe_genome(pm->head, frame, ix);
+		fprintf(stdout, "%3d: ", ix);
+		for (gene = 0; gene < pm->head->genenum; ++ gene)
+			fprintf(stdout, "%1d ", poolframe_gene(genome, gene));
+		fprintf(stdout, "%6.4f\n", poolframe_fitness(frame)[ix]);
+	}
+	fprintf(stdout, "\n");
+}
+
+/*____________________________________________________________________________*/
+int main(int argc, char **argv)
+{
+	Poolmap pm;
+
+	if (argc < 2 || argc > 3)
+	{
+		fprintf(stderr, "Usage: minset-pool POOLFILE [FRAME]\n"
+			"\tprints the frames of a binary pool file,\n"
+			"\tor the genomes of frame FRAME (-1: final pool)\n");
+		exit(1);
+	}
+
+	map_poolfile(argv[1], &pm);
+
+	if (argc == 2)
+		print_frames(&pm);
+	else
+		print_genomes(&pm, atoi(argv[2]) < 0 ? pm.head->n_frame - 1 : atoi(argv[2]));
+
+	unmap_poolfile(&pm);
+
+	return 0;
+}
+
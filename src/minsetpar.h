@@ -25,15 +25,22 @@ minsetpar.h : MinSet default parameters
 /* define generation of background distribution for most fitted */
 /*#define GENERATE_BACKGROUND*/
 
+/* score subsets by suffix trees of their concatenated sequences,
+	instead of by the precomputed k-word counts of their proteins */
+/*#define SUFFIX_TREE_SCORE*/
+
 /* number of randomly generated pools for background distribution */
 #define NUMRAN_POOL 2500 
 
 /* subset parameters */
 #define BASESET "masterfilelist" /* base set of proteins: list of sequence file names */
 #define SEQDIR "fastas/" /* relative path to directory containing sequence files */
+#define CORPUS "" /* binary corpus file of the base set, replaces BASESET and SEQDIR */
+#define PACK "" /* write the base set to this binary corpus file and exit */
 #define ALPHABET "TOP2006" /* coding alphabet */
 #define SUBSETSIZE 20. /* target size of subset relative to base set size (in % units) */
 #define KWORDLENGTH 2 /* selection k-word (fragment) length */
+#define DELTA_PARENTS 4 /* fittest genomes kept as reference for incremental scoring */
 
 #endif
 
@@ -35,7 +35,7 @@ void license()
 
 /*____________________________________________________________________________*/
 /* usage */
-void usage(Gapar *gapar, Minset *ms)
+void usage(Gapar *gapar, Minset *ms, int status)
 {
 	fprintf(stderr, "Usage: minset --baseset <baseset [FILE]>\n");
 	fprintf(stderr, "\nOptions:\n"
@@ -57,9 +57,21 @@ void usage(Gapar *gapar, Minset *ms)
 		"\t--equilibrium \t [BOOL]  \t %3d \t\t equilibrium breeding\n"
 		"\t--jackknife   \t [INT]   \t %3d \t\t split into 'JACKKNIFE' parts\n"
 		"\t--repeat      \t [INT]   \t %3d \t\t repeat GA 'REPEAT' times\n"
+		"\t--threads     \t [INT]   \t %3d \t\t number of worker threads for fitness evaluation\n"
+		"\t--fill        \t [BOOL]  \t %3d \t\t fill constrained genomes up to the subset size\n"
+		"\t--seed        \t [INT]   \t %3d \t\t seed of random number streams (0: from clock)\n"
+		"\t--islands     \t [INT]   \t %3d \t\t number of sub-pools evolving on separate threads\n"
+		"\t--migration   \t [INT]   \t %3d \t\t generations between migrations among islands\n"
+		"\t--jobs        \t [INT]   \t %3d \t\t number of GA runs (repeats, jackknife) at a time\n"
+		"\t--checkpoint  \t [INT]   \t %3d \t\t generations between checkpoints, 0: none\n"
+		"\t--resume      \t [CHAR]  \t %s \t\t checkpoint file of the run to resume\n"
+		"\t--poolbin     \t [BOOL]  \t %3d \t\t write binary pool file (1) or not (0)\n"
+		"\t--frames      \t [INT]   \t %3d \t\t generations between pool file frames, 0: none\n"
 		"  MINSET\n"
         "\t--baseset    \t [CHAR]  \t %s \t base set of proteins\n"
         "\t--seqdir      \t [CHAR]  \t %s \t relative path to directory holding sequence files\n"
+        "\t--corpus      \t [CHAR]  \t %s \t\t binary corpus file of the base set, replaces --baseset\n"
+        "\t--pack        \t [CHAR]  \t %s \t\t write base set to binary corpus file and exit\n"
         "\t--alphabet    \t [CHAR]  \t %s \t coding alphabet\n"
         "\t--subsetsize  \t [FLOAT] \t %3.0f \t\t target size of subset in percent units relative to base set\n"
         "\t--kwordlength \t [INT]   \t %3d \t\t selection k-word (fragment) length\n"
@@ -72,10 +84,20 @@ void usage(Gapar *gapar, Minset *ms)
 		gapar->lowlim, gapar->uplim, gapar->minimize, gapar->maximize,
 		gapar->random, gapar->seeded, gapar->maxvar,
 		gapar->crossover, gapar->equilibrium, 
-		gapar->jackknife, gapar->repeat, ms->basesetFileName, ms->seqdir,
+		gapar->jackknife, gapar->repeat, gapar->threads,
+		gapar->fill,
+		gapar->seed,
+		gapar->islands,
+		gapar->migration,
+		gapar->jobs,
+		gapar->checkpoint, gapar->resumeFileName,
+		gapar->poolbin,
+		gapar->frames,
+		ms->basesetFileName, ms->seqdir,
+		ms->corpusFileName, ms->packFileName,
 		ms->alphabet.name, ms->subsetsize, ms->kword_len); 
 
-	exit(1);
+	exit(status);
 }
 
 /*____________________________________________________________________________*/
@@ -101,8 +123,20 @@ void print_pars(Gapar *gapar, Minset *ms, FILE *outfile)
 		"equilibrium %3d\n"
 		"jackknife %3d\n"
 		"repeat %3d\n"
+		"threads %3d\n"
+		"fill %3d\n"
+		"seed %3d\n"
+		"islands %3d\n"
+		"migration %3d\n"
+		"jobs %3d\n"
+		"checkpoint %3d\n"
+		"resume %s\n"
+		"poolbin %3d\n"
+		"frames %3d\n"
         "baseset %s\n"
         "seqdir %s\n"
+        "corpus %s\n"
+        "pack %s\n"
         "alphabet %s\n"
         "subsetsize %3.0f\n"
         "kwordlength %3d\n",
@@ -110,7 +144,17 @@ void print_pars(Gapar *gapar, Minset *ms, FILE *outfile)
 		gapar->lowlim, gapar->uplim, gapar->minimize, gapar->maximize,
 		gapar->random, gapar->seeded, gapar->maxvar,
 		gapar->crossover, gapar->equilibrium, 
-		gapar->jackknife, gapar->repeat, ms->basesetFileName, ms->seqdir,
+		gapar->jackknife, gapar->repeat, gapar->threads,
+		gapar->fill,
+		gapar->seed,
+		gapar->islands,
+		gapar->migration,
+		gapar->jobs,
+		gapar->checkpoint, gapar->resumeFileName,
+		gapar->poolbin,
+		gapar->frames,
+		ms->basesetFileName, ms->seqdir,
+		ms->corpusFileName, ms->packFileName,
 		ms->alphabet.name, ms->subsetsize, ms->kword_len); 
 
 	fclose(parFile);
@@ -141,16 +185,28 @@ void parse_args(int argc, char **argv, Gapar *gaPar, Minset *ms, FILE *outfile)
 		{"equilibrium", required_argument, 0, 13},
 		{"jackknife", required_argument, 0, 14},
 		{"repeat", required_argument, 0, 15},
+		{"threads", required_argument, 0, 16},
+		{"fill", required_argument, 0, 17},
+		{"seed", required_argument, 0, 18},
+		{"islands", required_argument, 0, 19},
+		{"migration", required_argument, 0, 20},
+		{"jobs", required_argument, 0, 21},
+		{"checkpoint", required_argument, 0, 22},
+		{"resume", required_argument, 0, 23},
+		{"poolbin", required_argument, 0, 24},
+		{"frames", required_argument, 0, 25},
         {"baseset", required_argument, 0, 101},
         {"seqdir", required_argument, 0, 102},
         {"alphabet", required_argument, 0, 103},
         {"subsetsize", required_argument, 0, 104},
         {"kwordlength", required_argument, 0, 105},
+        {"pack", required_argument, 0, 106},
+        {"corpus", required_argument, 0, 107},
         {"help", no_argument, 0, 1001},
 		{0, 0, 0, 0}
 	};
 
-	while ((c = getopt_long (argc, argv, "1:2:3:4:5:6:7:8:9:10:11:12:13:14:15:101:102:103:104:105:1001", long_options, NULL)) != -1)
+	while ((c = getopt_long (argc, argv, "1:2:3:4:5:6:7:8:9:10:11:12:13:14:15:16:17:18:19:20:21:22:23:24:25:101:102:103:104:105:106:107:1001", long_options, NULL)) != -1)
 	{
 		switch(c)
 		{
@@ -214,6 +270,46 @@ void parse_args(int argc, char **argv, Gapar *gaPar, Minset *ms, FILE *outfile)
 				gaPar->repeat = atoi(optarg); assert(gaPar->repeat > 0);
 				fprintf(stdout, "REPEAT set to value %d\n", gaPar->repeat);
 				break;
+			case 16:
+				gaPar->threads = atoi(optarg); assert(gaPar->threads > 0);
+				fprintf(stdout, "THREADS set to value %d\n", gaPar->threads);
+				break;
+			case 17:
+				gaPar->fill = atoi(optarg); assert(gaPar->fill >= 0);
+				fprintf(stdout, "FILL set to value %d\n", gaPar->fill);
+				break;
+			case 18:
+				gaPar->seed = atoi(optarg); assert(gaPar->seed >= 0);
+				fprintf(stdout, "SEED set to value %d\n", gaPar->seed);
+				break;
+			case 19:
+				gaPar->islands = atoi(optarg); assert(gaPar->islands > 0);
+				fprintf(stdout, "ISLANDS set to value %d\n", gaPar->islands);
+				break;
+			case 20:
+				gaPar->migration = atoi(optarg); assert(gaPar->migration > 0);
+				fprintf(stdout, "MIGRATION set to value %d\n", gaPar->migration);
+				break;
+			case 21:
+				gaPar->jobs = atoi(optarg); assert(gaPar->jobs > 0);
+				fprintf(stdout, "JOBS set to value %d\n", gaPar->jobs);
+				break;
+			case 22:
+				gaPar->checkpoint = atoi(optarg); assert(gaPar->checkpoint >= 0);
+				fprintf(stdout, "CHECKPOINT set to value %d\n", gaPar->checkpoint);
+				break;
+			case 23:
+				strcpy(gaPar->resumeFileName, optarg); assert(strlen(gaPar->resumeFileName) > 0);
+				fprintf(stdout, "RESUME set to name %s\n", gaPar->resumeFileName);
+				break;
+			case 24:
+				gaPar->poolbin = atoi(optarg); assert(gaPar->poolbin >= 0);
+				fprintf(stdout, "POOLBIN set to value %d\n", gaPar->poolbin);
+				break;
+			case 25:
+				gaPar->frames = atoi(optarg); assert(gaPar->frames >= 0);
+				fprintf(stdout, "FRAMES set to value %d\n", gaPar->frames);
+				break;
             case 101:
                 strcpy(ms->basesetFileName, optarg); assert (strlen(ms->basesetFileName) > 1);
                 fprintf(stdout, "PROTLIST set to name %s\n", ms->basesetFileName);
@@ -234,8 +330,19 @@ void parse_args(int argc, char **argv, Gapar *gaPar, Minset *ms, FILE *outfile)
                 ms->kword_len = atoi(optarg); assert (ms->kword_len > 0);
                 fprintf(stdout, "KWORDLENGTH set to value %d\n", ms->kword_len);
                 break;
+            case 106:
+                strcpy(ms->packFileName, optarg);
+                fprintf(stdout, "PACK set to name %s\n", ms->packFileName);
+                break;
+            case 107:
+                strcpy(ms->corpusFileName, optarg);
+                fprintf(stdout, "CORPUS set to name %s\n", ms->corpusFileName);
+                break;
+			case 1001:
+				usage(gaPar, ms, 0);
+				break;
 			default:
-				usage(gaPar, ms);
+				usage(gaPar, ms, 1);
 				break;	
 		}
 	}
@@ -248,8 +355,10 @@ void parse_args(int argc, char **argv, Gapar *gaPar, Minset *ms, FILE *outfile)
 	assert((gaPar->equilibrium == 0 && gaPar->crossover == 1) || \
 		(gaPar->equilibrium == 1 && gaPar->crossover == 0));
 
+	/* random numbers: seed from clock unless specified */
+	if (gaPar->seed == 0)
+		gaPar->seed = (int)(time(NULL) % 100000) + 1;
 
-	print_pars(gaPar, ms, outfile);
 	fprintf(stdout, "\n");
 }
 
@@ -24,7 +24,8 @@ parse_args.h : parse command line arguments
 #include "minset.h"
 
 void license( void );
-void usage( void );
+void usage(Gapar *gapar, Minset *ms, int status);
+void print_pars(Gapar *gapar, Minset *ms, FILE *outfile);
 void parse_args(int argc, char **argv, Gapar *gapar, Minset *ms, FILE *outfile);
 
 #endif
@@ -0,0 +1,90 @@
+/*==============================================================================
+poolfile.c : memory-mapped reader of binary pool files
+(C) 2006-2017 Jens Kleinjung
+(C) 2006-2007 Alessandro Pandini
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+==============================================================================*/
+
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "poolfile.h"
+
+/*____________________________________________________________________________*/
+/* map pool file 'fileName' and index its frames; */
+/* exits if the file is not a complete pool file */
+void map_poolfile(const char *fileName, Poolmap *pm)
+{
+	int i;
+	int fd;
+	size_t offset;
+	struct stat st;
+	const Poolframe *frame;
+
+	if ((fd = open(fileName, O_RDONLY)) < 0 || fstat(fd, &st) != 0)
+	{
+		fprintf(stderr, "Exiting: cannot open pool file %s\n", fileName);
+		exit(1);
+	}
+	pm->size = st.st_size;
+	if (pm->size < sizeof(Poolhead) ||
+		(pm->map = mmap(0, pm->size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+	{
+		fprintf(stderr, "Exiting: cannot map pool file %s\n", fileName);
+		exit(1);
+	}
+	close(fd);
+
+	pm->head = (const Poolhead *)pm->map;
+	if (memcmp(pm->head->magic, POOLFILE_MAGIC, sizeof(pm->head->magic)) != 0 ||
+		pm->head->version != POOLFILE_VERSION)
+	{
+		fprintf(stderr, "Exiting: %s is not a pool file of version %d\n",
+			fileName, POOLFILE_VERSION);
+		exit(1);
+	}
+
+	/* frames have variable size: walk and check them once */
+	if ((pm->frame = malloc((pm->head->n_frame + 1) * sizeof(Poolframe *))) == 0)
+	{
+		fprintf(stderr, "Exiting: memory allocation failed\n");
+		exit(1);
+	}
+	for (i = 0, offset = sizeof(Poolhead); i < pm->head->n_frame; ++ i)
+	{
+		frame = (const Poolframe *)(pm->map + offset);
+		if (offset + sizeof(Poolframe) > pm->size || frame->n_genome < 0 ||
+			(offset += poolframe_size(pm->head, frame->n_genome)) > pm->size)
+		{
+			fprintf(stderr, "Exiting: pool file %s is truncated at frame %d\n", fileName, i);
+			exit(1);
+		}
+		pm->frame[i] = frame;
+	}
+}
+
+/*____________________________________________________________________________*/
+void unmap_poolfile(Poolmap *pm)
+{
+	munmap(pm->map, pm->size);
+	free(pm->frame);
+}
+
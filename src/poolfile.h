@@ -0,0 +1,123 @@
+/*==============================================================================
+poolfile.h : binary pool file format and memory-mapped reader
+(C) 2006-2017 Jens Kleinjung
+(C) 2006-2007 Alessandro Pandini
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+==============================================================================*/
+
+
+#if !defined(POOLFILE_H)
+#define POOLFILE_H
+
+/*____________________________________________________________________________*/
+/* includes */
+#include <stddef.h>
+#include <stdint.h>
+
+/*____________________________________________________________________________*/
+/* defines */
+#define POOLFILE_MAGIC "MINSETPL" /* first 8 bytes of a pool file */
+#define POOLFILE_VERSION 1 /* version of the pool file layout */
+
+/*____________________________________________________________________________*/
+/* structures */
+
+/* A pool file holds the gene pools of one GA run in native byte order:
+	a Poolhead, followed by 'n_frame' frames. Each frame is a Poolframe,
+	the fitness column of its genomes (padded to 8 bytes) and the genomes,
+	bit-packed into 'n_word' 64-bit words each (gene i is bit i % 64 of word
+	i / 64). Genomes are ordered fittest first.
+	Frames 0 to n_frame - 2 are full pools of all islands, every 'frames'
+	generations in the order generation, island; the last frame holds the
+	fittest genomes of the final pool. */
+
+typedef struct
+{
+	char magic[8]; /* POOLFILE_MAGIC, not terminated */
+	int version; /* POOLFILE_VERSION */
+	int genenum; /* number of genes */
+	int n_word; /* 64-bit words per genome */
+	int popsize; /* population size */
+	int fitmate; /* number of fittest genomes to mate */
+	int islands; /* number of islands */
+	int frames; /* generations between frames, 0 for the final pool only */
+	int minimize; /* lowest fitness is fittest */
+	int seed; /* seed of random number streams */
+	int j, k; /* repeat and jackknife fraction of the run */
+	int n_frame; /* number of frames */
+} Poolhead;
+
+typedef struct
+{
+	int generation; /* generation of the pool, for the final pool as in the '.ga' file */
+	int island; /* island of the pool */
+	int n_genome; /* number of genomes */
+	int final; /* final pool of the run */
+} Poolframe;
+
+/* memory-mapped pool file */
+typedef struct
+{
+	unsigned char *map; /* file contents */
+	size_t size; /* file size */
+	const Poolhead *head; /* file header */
+	const Poolframe **frame; /* frames */
+} Poolmap;
+
+/*____________________________________________________________________________*/
+/* size of the fitness column of 'n_genome' genomes */
+static inline size_t poolframe_fitness_size(int n_genome)
+{
+	return (n_genome * sizeof(float) + 7) & ~(size_t)7;
+}
+
+/* size of a frame of 'n_genome' genomes */
+static inline size_t poolframe_size(const Poolhead *head, int n_genome)
+{
+	return sizeof(Poolframe) + poolframe_fitness_size(n_genome) +
+		(size_t)n_genome * head->n_word * sizeof(uint64_t);
+}
+
+/* file offset of frame 'i', preceded by full pools only */
+static inline size_t poolframe_offset(const Poolhead *head, int i)
+{
+	return sizeof(Poolhead) + (size_t)i * poolframe_size(head, head->popsize);
+}
+
+/* fitness column of a frame */
+static inline const float *poolframe_fitness(const Poolframe *frame)
+{
+	return (const float *)(frame + 1);
+}
+
+/* genome 'ix' of a frame */
+static inline const uint64_t *poolframe_genome(const Poolhead *head, const Poolframe *frame, int ix)
+{
+	return (const uint64_t *)((const unsigned char *)(frame + 1) +
+		poolframe_fitness_size(frame->n_genome)) + (size_t)ix * head->n_word;
+}
+
+/* state of gene 'i' of a packed genome */
+static inline int poolframe_gene(const uint64_t *genome, int i)
+{
+	return (int)((genome[i / 64] >> (i % 64)) & 1);
+}
+
+/*____________________________________________________________________________*/
+/* prototypes */
+void map_poolfile(const char *fileName, Poolmap *pm);
+void unmap_poolfile(Poolmap *pm);
+
+#endif
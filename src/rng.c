@@ -0,0 +1,100 @@
+/*==============================================================================
+rng.c : random number streams
+(C) 2006-2017 Jens Kleinjung
+(C) 2006-2007 Alessandro Pandini
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+==============================================================================*/
+
+/* Every stream of random numbers is a xoshiro256** generator whose state
+	is derived from the run seed and the position of its consumer in the GA
+	(repeat, jackknife fraction, generation, genome slot). Streams are
+	therefore independent of the order in which genomes are processed and
+	of the number of threads processing them. */
+
+#include "rng.h"
+
+/*____________________________________________________________________________*/
+/* splitmix64: next output of the sequence with state 'x' */
+static uint64_t splitmix64(uint64_t *x)
+{
+	uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/*____________________________________________________________________________*/
+/* seed the stream of genome 'slot' in 'generation' of a GA run */
+void seed_rng(Rng *rng, uint64_t seed, int repeat, int fraction, int generation, int slot)
+{
+	int i;
+	uint64_t x = seed;
+
+	/* hash the stream coordinates into the splitmix64 state */
+	x = splitmix64(&x) ^ (uint32_t)repeat;
+	x = splitmix64(&x) ^ (uint32_t)fraction;
+	x = splitmix64(&x) ^ (uint32_t)generation;
+	x = splitmix64(&x) ^ (uint32_t)slot;
+
+	for (i = 0; i < 4; ++ i)
+		rng->s[i] = splitmix64(&x);
+}
+
+/*____________________________________________________________________________*/
+static inline uint64_t rotl(uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+/*____________________________________________________________________________*/
+/* xoshiro256**: 64 random bits */
+uint64_t rand_bits(Rng *rng)
+{
+	uint64_t *s = rng->s;
+	uint64_t result = rotl(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 45);
+
+	return result;
+}
+
+/*____________________________________________________________________________*/
+/* uniform random integer in range [0,n), n > 0 */
+/* (Lemire's multiply-shift range reduction, division only on rejection) */
+uint32_t rand_below(Rng *rng, uint32_t n)
+{
+	uint64_t m = (rand_bits(rng) >> 32) * n;
+	uint32_t low = (uint32_t)m;
+	uint32_t threshold;
+
+	if (low < n)
+	{
+		threshold = -n % n;
+		while (low < threshold)
+		{
+			m = (rand_bits(rng) >> 32) * n;
+			low = (uint32_t)m;
+		}
+	}
+
+	return (uint32_t)(m >> 32);
+}
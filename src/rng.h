@@ -0,0 +1,42 @@
+/*==============================================================================
+rng.h : random number streams
+(C) 2006-2017 Jens Kleinjung
+(C) 2006-2007 Alessandro Pandini
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+==============================================================================*/
+
+#if !defined(RNG_H)
+#define RNG_H
+
+/*____________________________________________________________________________*/
+/* includes */
+#include <stdint.h>
+
+/*____________________________________________________________________________*/
+/* structures */
+
+/* state of a xoshiro256** random number generator */
+typedef struct
+{
+	uint64_t s[4];
+} Rng;
+
+/*____________________________________________________________________________*/
+/* prototypes */
+void seed_rng(Rng *rng, uint64_t seed, int repeat, int fraction, int generation, int slot);
+uint64_t rand_bits(Rng *rng);
+uint32_t rand_below(Rng *rng, uint32_t n);
+
+#endif
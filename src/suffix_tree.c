@@ -50,21 +50,21 @@ ST_CreateTree:
 For implementation interpretations see Basic Ideas paragraph in the Developement
 section of the readme.txt file.
 
-An example of the implementations of a node and its sons using linked lists
-instead of arrays:
+An example of the implementation of a node and its sons using blocks of sons
+instead of linked lists:
 
    (1)
     |
-    |
-    |
-   (2)--(3)--(4)--(5)
+    +------+------+------+
+    |      |      |      |
+   (2)    (3)    (4)    (5)
 
-(2) is the only son of (1) (call it the first son). Other sons of (1) are
-connected using a linked lists starting from (2) and going to the right. (3) is
-the right sibling of (2) (and (2) is the left sibling of (3)), (4) is the right
-sibling of (3), etc.
-The father field of all (2), (3), (4) and (5) points to (1), but the son field
-of (1) points only to (2).
+All nodes are stored in one array and refer to each other by 32 bit indices.
+Every internal node owns a block of sons in the arena, which lists the indices
+of (2), (3), (4) and (5) with the first characters of their incoming edges,
+sorted by character. Finding a son scans at most one entry per character of
+the alphabet, a few bytes in one cache line. Leaves have no block.
+The father field of all (2), (3), (4) and (5) holds the index of (1).
 
 *******************************************************************************/
 
@@ -87,14 +87,6 @@ typedef enum RULE_2_TYPE   {new_son, split}                RULE_2_TYPE;
 /* Signals whether last matching position is the last one of the current edge */
 typedef enum LAST_POS_TYPE {last_char_in_edge, other_char} LAST_POS_TYPE;
 
-/* Used for statistic measures of speed. */
-DBL_WORD counter;
-/* Used for statistic measures of space. */
-DBL_WORD heap;
-/* Used to mark the node that has no suffix link yet. By Ukkonen, it will have
-   one by the end of the current phase. */
-NODE*    suffixless;
-
 typedef struct SUFFIXTREEPATH
 {
    DBL_WORD   begin;
@@ -123,44 +115,338 @@ typedef struct SUFFIXTREEPOS
 
 /******************************************************************************/
 /*
-   create_node :
-   Creates a node with the given init field-values.
+   node_at, node_index :
+   Convert between node indices and node pointers. Index 0 corresponds to the
+   null pointer.
+*/
 
-  Input : The father of the node, the starting and ending indices 
-  of the incloming edge to that node, 
-        the path starting position of the node.
+NODE* node_at(SUFFIX_TREE* tree, ST_INDEX i)
+{
+   return i ? &(tree->arena->node[i]) : 0;
+}
 
-  Output: A pointer to that node.
+ST_INDEX node_index(SUFFIX_TREE* tree, NODE* node)
+{
+   return node ? (ST_INDEX)(node - tree->arena->node) : 0;
+}
+
+/******************************************************************************/
+/*
+   son_entry :
+   Returns the entry of the block of sons of an internal node for the son whose
+   incoming edge starts with a certain character.
+
+   Input : The tree, the (internal) node and the character.
+
+   Output: The index of the entry in the arena, 0 if there is no such son.
+*/
+
+ST_INDEX son_entry(SUFFIX_TREE* tree, NODE* node, char character)
+{
+   unsigned char* block = &(tree->arena->son_char[node->sons]);
+   unsigned char* found = memchr(block, (unsigned char)character, node->n_sons);
+
+   if(found == 0)
+      return 0;
+   return node->sons + (ST_INDEX)(found - block);
+}
+
+/******************************************************************************/
+/*
+   ST_CreateArena, ST_ResetArena, ST_DeleteArena :
+   See suffix_tree.h for description.
+*/
+
+NODE_ARENA* ST_CreateArena(void)
+{
+   NODE_ARENA* arena = (NODE_ARENA*)malloc(sizeof(NODE_ARENA));
+   int         c;
+
+   if(arena == 0)
+   {
+      printf("\nOut of memory.\n");
+      exit(0);
+   }
+   arena->node        = 0;
+   arena->n_node      = 0;
+   arena->node_size   = 0;
+   arena->sons        = 0;
+   arena->son_char    = 0;
+   arena->n_sons      = 0;
+   arena->sons_size   = 0;
+   for(c = 0; c < ST_SON_BLOCKS; c++)
+      arena->free_sons[c] = 0;
+   arena->string      = 0;
+   arena->string_size = 0;
+   return arena;
+}
+
+void ST_ResetArena(NODE_ARENA* arena)
+{
+   int c;
+
+   /* Index 0 stands for 'no node' and 'no sons', so it is never handed out */
+   arena->n_node = 1;
+   arena->n_sons = 1;
+   for(c = 0; c < ST_SON_BLOCKS; c++)
+      arena->free_sons[c] = 0;
+}
+
+void ST_DeleteArena(NODE_ARENA* arena)
+{
+   if(arena == 0)
+      return;
+   free(arena->node);
+   free(arena->sons);
+   free(arena->son_char);
+   free(arena->string);
+   free(arena);
+}
+
+/******************************************************************************/
+/*
+   arena_reserve :
+   Makes sure that the arena can hold the usual tree of a string: a tree over
+   n characters (including $) has n leaves and at most n-1 internal nodes, plus
+   the root, but strings of a small alphabet that are not repetitive give about
+   n/2 internal nodes or less. Nodes beyond that are made room for by
+   arena_grow. The blocks of sons take about 1.25 entries per node, more
+   are made room for by take_sons. Memory is only reallocated when the arena is too small, otherwise
+   it is reused.
+
+   Input : The arena and the string length (including $).
+
+   Output: None.
 */
 
+void arena_reserve(NODE_ARENA* arena, DBL_WORD length)
+{
+   DBL_WORD n_node = length+length/2+3;
+   DBL_WORD sons_size = n_node+n_node/4;
 
-NODE* create_node(NODE* father, DBL_WORD start, DBL_WORD end, DBL_WORD position)
+   if(2*length+2 >= (ST_INDEX)-1)
+   {
+      printf("\nString too long for 32 bit node indices.\n");
+      exit(0);
+   }
+   if(arena->node_size < n_node)
+   {
+      free(arena->node);
+      arena->node_size = (ST_INDEX)n_node;
+      arena->node = (NODE*)malloc(arena->node_size*sizeof(NODE));
+   }
+   if(arena->sons_size < sons_size)
+   {
+      free(arena->sons);
+      free(arena->son_char);
+      arena->sons_size = sons_size;
+      arena->sons = (ST_INDEX*)malloc(arena->sons_size*sizeof(ST_INDEX));
+      arena->son_char = (unsigned char*)malloc(arena->sons_size*sizeof(unsigned char));
+   }
+   if(arena->node == 0 || arena->sons == 0 || arena->son_char == 0)
+   {
+      printf("\nOut of memory.\n");
+      exit(0);
+   }
+}
+
+/******************************************************************************/
+/*
+   arena_grow :
+   Makes room for the two nodes an extension may create. If the arena holds no
+   more nodes, the node array is extended by n/4 nodes, up to the largest
+   possible tree of 2n+2 nodes, and the node pointers of the construction state
+   are moved with it. Called between two extensions, when no other node
+   pointers are held.
+
+   Input : The tree and the current position of the construction.
+
+   Output: None.
+*/
+
+void arena_grow(SUFFIX_TREE* tree, POS* pos)
 {
-   /*Allocate a node.*/
-   NODE* node   = (NODE*)malloc(sizeof(NODE));
-   if(node == 0)
+   NODE_ARENA* arena = tree->arena;
+   ST_INDEX    root, suffixless, node;
+
+   if(arena->n_node+2 <= arena->node_size)
+      return;
+
+   root       = node_index(tree, tree->root);
+   suffixless = node_index(tree, tree->suffixless);
+   node       = node_index(tree, pos->node);
+
+   arena->node_size += (ST_INDEX)(tree->length/4+2);
+   if(arena->node_size > 2*tree->length+2)
+      arena->node_size = (ST_INDEX)(2*tree->length+2);
+   arena->node = (NODE*)realloc(arena->node, arena->node_size*sizeof(NODE));
+   if(arena->node == 0)
    {
       printf("\nOut of memory.\n");
       exit(0);
    }
 
+   tree->root       = node_at(tree, root);
+   tree->suffixless = node_at(tree, suffixless);
+   pos->node        = node_at(tree, node);
+}
+
+/******************************************************************************/
+/*
+   son_block :
+   Returns the size class of a block of sons: 0 for 2 sons, 1 for 4 sons etc.
+*/
+
+int son_block(ST_INDEX size)
+{
+   int c;
+
+   for(c = 0; (2u << c) < size; c++)
+      ;
+   return c;
+}
+
+/******************************************************************************/
+/*
+   give_sons :
+   Gives up a block of entries for sons, to be taken again by take_sons.
+
+   Input : The tree, the index of the first entry and the number of entries.
+
+   Output: None.
+*/
+
+void give_sons(SUFFIX_TREE* tree, ST_INDEX first, ST_INDEX size)
+{
+   NODE_ARENA* arena = tree->arena;
+   int         c = son_block(size);
+
+   arena->sons[first]  = arena->free_sons[c];
+   arena->free_sons[c] = first;
+}
+
+/******************************************************************************/
+/*
+   take_sons :
+   Takes a block of entries for sons from the arena: a given up block of that
+   size if there is one, else a new block, extending the arena if it is full.
+
+   Input : The tree and the number of entries.
+
+   Output: The index of the first entry.
+*/
+
+ST_INDEX take_sons(SUFFIX_TREE* tree, ST_INDEX size)
+{
+   NODE_ARENA* arena = tree->arena;
+   ST_INDEX    first = arena->n_sons;
+   int         c = son_block(size);
+
+   if(arena->free_sons[c] != 0)
+   {
+      first = arena->free_sons[c];
+      arena->free_sons[c] = arena->sons[first];
+      return first;
+   }
+
+   if((DBL_WORD)first+size > arena->sons_size)
+   {
+      arena->sons_size += arena->sons_size/2+size;
+      arena->sons = (ST_INDEX*)realloc(arena->sons, arena->sons_size*sizeof(ST_INDEX));
+      arena->son_char = (unsigned char*)realloc(arena->son_char, arena->sons_size*sizeof(unsigned char));
+      if(arena->sons == 0 || arena->son_char == 0)
+      {
+         printf("\nOut of memory.\n");
+         exit(0);
+      }
+   }
+   arena->n_sons += size;
+
 #ifdef STATISTICS
-   heap+=sizeof(NODE);
+   tree->heap+=size*(sizeof(ST_INDEX)+sizeof(unsigned char));
+#endif
+   return first;
+}
+
+/******************************************************************************/
+/*
+   create_node :
+   Creates a node with the given init field-values.
+
+  Input : The tree, the father of the node, the starting and ending indices 
+  of the incloming edge to that node, 
+        the path starting position of the node, and whether the node is
+        internal (then it gets an empty block of sons).
+
+  Output: A pointer to that node.
+*/
+
+
+NODE* create_node(SUFFIX_TREE* tree, NODE* father, DBL_WORD start, DBL_WORD end, DBL_WORD position, char internal)
+{
+   NODE_ARENA* arena = tree->arena;
+   /*Take a node from the tree's arena.*/
+   NODE* node   = &(arena->node[arena->n_node++]);
+
+#ifdef STATISTICS
+   tree->heap+=sizeof(NODE);
 #endif
 
    /* Initialize node fields. For detailed description of the fields see
       suffix_tree.h */
    node->sons             = 0;
-   node->right_sibling    = 0;
-   node->left_sibling     = 0;
+   node->n_sons           = 0;
    node->suffix_link      = 0;
-   node->father           = father;
+   node->father           = node_index(tree, father);
    node->path_position    = position;
    node->edge_label_start = start;
    node->edge_label_end   = end;
+
+   if(internal)
+      node->sons = take_sons(tree, 2);
    return node;
 }
 
+/******************************************************************************/
+/*
+   add_son :
+   Adds a son to an internal node, in the order of the first characters of the
+   sons' incoming edges. A full block of sons is first copied to a new block of
+   twice the size.
+
+   Input : The tree, the (internal) node and the new son.
+
+   Output: None.
+*/
+
+void add_son(SUFFIX_TREE* tree, NODE* node, NODE* son)
+{
+   NODE_ARENA*   arena = tree->arena;
+   unsigned char character = (unsigned char)tree->tree_string[son->edge_label_start];
+   ST_INDEX      i, size;
+
+   for(size = 2; size < node->n_sons; size *= 2)
+      ;
+   if(node->n_sons == size)
+   {
+      i = take_sons(tree, 2*size);
+      memcpy(&(arena->sons[i]), &(arena->sons[node->sons]), node->n_sons*sizeof(ST_INDEX));
+      memcpy(&(arena->son_char[i]), &(arena->son_char[node->sons]), node->n_sons*sizeof(unsigned char));
+      give_sons(tree, node->sons, size);
+      node->sons = i;
+   }
+
+   /* Sons with larger characters move up by one entry */
+   for(i = node->sons+node->n_sons; i > node->sons && arena->son_char[i-1] > character; i--)
+   {
+      arena->sons[i]     = arena->sons[i-1];
+      arena->son_char[i] = arena->son_char[i-1];
+   }
+   arena->sons[i]     = node_index(tree, son);
+   arena->son_char[i] = character;
+   node->n_sons++;
+}
+
 /******************************************************************************/
 /*
    find_son :
@@ -174,18 +460,20 @@ NODE* create_node(NODE* father, DBL_WORD start, DBL_WORD end, DBL_WORD position)
 
 NODE* find_son(SUFFIX_TREE* tree, NODE* node, char character)
 {
-   /* Point to the first son. */
-   node = node->sons;
-   /* scan all sons (all right siblings of the first son) for their first
-   character (it has to match the character given as input to this function. */
-   while(node != 0 && tree->tree_string[node->edge_label_start] != character)
-   {
+   ST_INDEX entry;
+
 #ifdef STATISTICS
-      counter++;
+   tree->counter++;
 #endif
-      node = node->right_sibling;
-   }
-   return node;
+
+   /* A leaf has no sons */
+   if(node->sons == 0)
+      return 0;
+   /* Look up the son in the node's block of sons */
+   entry = son_entry(tree, node, character);
+   if(entry == 0)
+      return 0;
+   return node_at(tree, tree->arena->sons[entry]);
 }
 
 /******************************************************************************/
@@ -246,26 +534,6 @@ char is_last_char_in_edge(SUFFIX_TREE* tree, NODE* node, DBL_WORD edge_pos)
    return 0;
 }
 
-/******************************************************************************/
-/*
-   connect_siblings :
-   Connect right_sib as the right sibling of left_sib and vice versa.
-
-   Input : The two nodes to be connected.
-
-   Output: None.
-*/
-
-void connect_siblings(NODE* left_sib, NODE* right_sib)
-{
-   /* Connect the right node as the right sibling of the left node */
-   if(left_sib != 0)
-      left_sib->right_sibling = right_sib;
-   /* Connect the left node as the left sibling of the right node */
-   if(right_sib != 0)
-      right_sib->left_sibling = left_sib;
-}
-
 /******************************************************************************/
 /*
    apply_extension_rule_2 :
@@ -288,6 +556,8 @@ void connect_siblings(NODE* left_sib, NODE* right_sib)
 */
 
 NODE* apply_extension_rule_2(
+                      /* The tree */
+                      SUFFIX_TREE*    tree,
                       /* Node 1 (see drawings) */
                       NODE*           node,            
                       /* Start index of node 2's incoming edge */
@@ -304,7 +574,8 @@ NODE* apply_extension_rule_2(
 {
    NODE *new_leaf,
         *new_internal,
-        *son;
+        *father;
+   ST_INDEX father_entry;
    /*-------new_son-------*/
    if(type == new_son)                                       
    {
@@ -312,12 +583,9 @@ NODE* apply_extension_rule_2(
       printf("rule 2: new leaf (%lu,%lu)\n",edge_label_begin,edge_label_end);
 #endif
       /* Create a new leaf (4) with the characters of the extension */
-      new_leaf = create_node(node, edge_label_begin , edge_label_end, path_pos);
+      new_leaf = create_node(tree, node, edge_label_begin , edge_label_end, path_pos, 0);
       /* Connect new_leaf (4) as the new son of node (1) */
-      son = node->sons;
-      while(son->right_sibling != 0)
-         son = son->right_sibling;
-      connect_siblings(son, new_leaf);
+      add_son(tree, node, new_leaf);
       /* return (4) */
       return new_leaf;
    }
@@ -327,36 +595,35 @@ NODE* apply_extension_rule_2(
 #endif
    /* Create a new internal node (3) at the split point */
    new_internal = create_node(
-                      node->father,
+                      tree,
+                      node_at(tree, node->father),
                       node->edge_label_start,
                       node->edge_label_start+edge_pos,
-                      node->path_position);
+                      node->path_position,
+                      1);
    /* Update the node (1) incoming edge starting index (it now starts where node
    (3) incoming edge ends) */
    node->edge_label_start += edge_pos+1;
 
    /* Create a new leaf (2) with the characters of the extension */
    new_leaf = create_node(
+                      tree,
                       new_internal,
                       edge_label_begin,
                       edge_label_end,
-                      path_pos);
+                      path_pos,
+                      0);
    
-   /* Connect new_internal (3) where node (1) was */
-   /* Connect (3) with (1)'s left sibling */
-   connect_siblings(node->left_sibling, new_internal);   
-   /* connect (3) with (1)'s right sibling */
-   connect_siblings(new_internal, node->right_sibling);
-   node->left_sibling = 0;
-
-   /* Connect (3) with (1)'s father */
-   if(new_internal->father->sons == node)            
-      new_internal->father->sons = new_internal;
+   /* Connect new_internal (3) with (1)'s father, where node (1) was: both
+      edges start with the same character */
+   father = node_at(tree, new_internal->father);
+   father_entry = son_entry(tree, father, tree->tree_string[new_internal->edge_label_start]);
+   tree->arena->sons[father_entry] = node_index(tree, new_internal);
    
    /* Connect new_leaf (2) and node (1) as sons of new_internal (3) */
-   new_internal->sons = node;
-   node->father = new_internal;
-   connect_siblings(node, new_leaf);
+   add_son(tree, new_internal, node);
+   node->father = node_index(tree, new_internal);
+   add_son(tree, new_internal, new_leaf);
    /* return (3) */
    return new_internal;
 }
@@ -436,7 +703,7 @@ NODE* trace_single_edge(
       }
 
 #ifdef STATISTICS
-      counter++;
+      tree->counter++;
 #endif
 
       return node;
@@ -451,7 +718,7 @@ NODE* trace_single_edge(
       {
 
 #ifdef STATISTICS
-         counter++;
+         tree->counter++;
 #endif
 
          /* Compare current characters of the string and the edge. If equal - 
@@ -562,7 +829,7 @@ DBL_WORD ST_FindSubstring(
          k++;
 
 #ifdef STATISTICS
-         counter++;
+         tree->counter++;
 #endif
       }
       
@@ -626,7 +893,7 @@ void follow_suffix_link(SUFFIX_TREE* tree, POS* pos)
          is linked to itself). Tracing from the root (like in the naive 
          algorithm) is required and is done by the calling function SEA uppon 
          recieving a return value of tree->root from this function */
-      if(pos->node->father == tree->root)
+      if(node_at(tree, pos->node->father) == tree->root)
       {
          pos->node = tree->root;
          return;
@@ -636,14 +903,14 @@ void follow_suffix_link(SUFFIX_TREE* tree, POS* pos)
       gama.begin      = pos->node->edge_label_start;
       gama.end      = pos->node->edge_label_start + pos->edge_pos;
       /* Follow father's suffix link */
-      pos->node      = pos->node->father->suffix_link;
+      pos->node      = node_at(tree, node_at(tree, pos->node->father)->suffix_link);
       /* Down-walk gama back to suffix_link's son */
       pos->node      = trace_string(tree, pos->node, gama, &(pos->edge_pos), &chars_found, skip);
    }
    else
    {
       /* If a suffix link exists - just follow it */
-      pos->node      = pos->node->suffix_link;
+      pos->node      = node_at(tree, pos->node->suffix_link);
       pos->edge_pos   = get_node_label_length(tree,pos->node)-1;
    }
 }
@@ -655,14 +922,14 @@ void follow_suffix_link(SUFFIX_TREE* tree, POS* pos)
    largest suffix. The function could be avoided but is needed to monitor the 
    creation of suffix links when debuging or changing the tree.
 
-   Input : The node to link from, the node to link to.
+   Input : The tree, the node to link from, the node to link to.
 
    Output: None.
 */
 
-void create_suffix_link(NODE* node, NODE* link)
+void create_suffix_link(SUFFIX_TREE* tree, NODE* node, NODE* link)
 {
-   node->suffix_link = link;
+   node->suffix_link = node_index(tree, link);
 }
 
 /******************************************************************************/
@@ -702,15 +969,18 @@ void SEA(
    ST_PrintTree(tree);
    printf("extension: %lu  phase+1: %lu",str.begin, str.end);
    if(after_rule_3 == 0)
-      printf("   followed from (%lu,%lu | %lu) ", pos->node->edge_label_start, get_node_label_end(tree,pos->node), pos->edge_pos);
+      printf("   followed from (%lu,%lu | %lu) ", (DBL_WORD)pos->node->edge_label_start, get_node_label_end(tree,pos->node), pos->edge_pos);
    else
-      printf("   starting at (%lu,%lu | %lu) ", pos->node->edge_label_start, get_node_label_end(tree,pos->node), pos->edge_pos);
+      printf("   starting at (%lu,%lu | %lu) ", (DBL_WORD)pos->node->edge_label_start, get_node_label_end(tree,pos->node), pos->edge_pos);
 #endif
 
 #ifdef STATISTICS
-   counter++;
+   tree->counter++;
 #endif
 
+   /* Room for the nodes of this extension */
+   arena_grow(tree, pos);
+
    /* Follow suffix link only if it's not the first extension after rule 3 was applied */
    if(after_rule_3 == 0)
       follow_suffix_link(tree, pos);
@@ -718,9 +988,9 @@ void SEA(
 #ifdef DEBUG   
 #ifdef STATISTICS
    if(after_rule_3 == 0)
-      printf("to (%lu,%lu | %lu). counter: %lu\n", pos->node->edge_label_start, get_node_label_end(tree,pos->node),pos->edge_pos,counter);
+      printf("to (%lu,%lu | %lu). counter: %lu\n", (DBL_WORD)pos->node->edge_label_start, get_node_label_end(tree,pos->node),pos->edge_pos,tree->counter);
    else
-      printf(". counter: %lu\n", counter);
+      printf(". counter: %lu\n", tree->counter);
 #endif
 #endif
 
@@ -766,11 +1036,11 @@ void SEA(
       /* If there is an internal node that has no suffix link yet (only one may 
          exist) - create a suffix link from it to the father-node of the 
          current position in the tree (pos) */
-      if(suffixless != 0)
+      if(tree->suffixless != 0)
       {
-         create_suffix_link(suffixless, pos->node->father);
+         create_suffix_link(tree, tree->suffixless, node_at(tree, pos->node->father));
          /* Marks that no internal node with no suffix link exists */
-         suffixless = 0;
+         tree->suffixless = 0;
       }
 
       #ifdef DEBUG   
@@ -788,16 +1058,16 @@ void SEA(
       {
          /* Apply extension rule 2 new son - a new leaf is created and returned 
             by apply_extension_rule_2 */
-         apply_extension_rule_2(pos->node, str.begin+chars_found, str.end, path_pos, 0, new_son);
+         apply_extension_rule_2(tree, pos->node, str.begin+chars_found, str.end, path_pos, 0, new_son);
          *rule_applied = 2;
          /* If there is an internal node that has no suffix link yet (only one 
             may exist) - create a suffix link from it to the father-node of the 
             current position in the tree (pos) */
-         if(suffixless != 0)
+         if(tree->suffixless != 0)
          {
-            create_suffix_link(suffixless, pos->node);
+            create_suffix_link(tree, tree->suffixless, pos->node);
             /* Marks that no internal node with no suffix link exists */
-            suffixless = 0;
+            tree->suffixless = 0;
          }
       }
    }
@@ -805,19 +1075,19 @@ void SEA(
    {
       /* Apply extension rule 2 split - a new node is created and returned by 
          apply_extension_rule_2 */
-      tmp = apply_extension_rule_2(pos->node, str.begin+chars_found, str.end, path_pos, pos->edge_pos, split);
-      if(suffixless != 0)
-         create_suffix_link(suffixless, tmp);
+      tmp = apply_extension_rule_2(tree, pos->node, str.begin+chars_found, str.end, path_pos, pos->edge_pos, split);
+      if(tree->suffixless != 0)
+         create_suffix_link(tree, tree->suffixless, tmp);
       /* Link root's sons with a single character to the root */
-      if(get_node_label_length(tree,tmp) == 1 && tmp->father == tree->root)
+      if(get_node_label_length(tree,tmp) == 1 && node_at(tree, tmp->father) == tree->root)
       {
-         tmp->suffix_link = tree->root;
+         tmp->suffix_link = node_index(tree, tree->root);
          /* Marks that no internal node with no suffix link exists */
-         suffixless = 0;
+         tree->suffixless = 0;
       }
       else
          /* Mark tmp as waiting for a link */
-         suffixless = tmp;
+         tree->suffixless = tmp;
       
       /* Prepare pos for the next extension */
       pos->node = tmp;
@@ -908,11 +1178,30 @@ void SPA(
 */
 
 SUFFIX_TREE* ST_CreateTree(const char* str, DBL_WORD length)
+{
+   SUFFIX_TREE*  tree;
+
+   if(str == 0)
+      return 0;
+
+   tree = ST_CreateTreeInArena(str, length, ST_CreateArena());
+   tree->own_arena = 1;
+   return tree;
+}
+
+/******************************************************************************/
+/*
+   ST_CreateTreeInArena :
+   See suffix_tree.h for description.
+*/
+
+SUFFIX_TREE* ST_CreateTreeInArena(const char* str, DBL_WORD length, NODE_ARENA* arena)
 {
    SUFFIX_TREE*  tree;
    DBL_WORD      phase , extension;
    char          repeated_extension = 0;
    POS           pos;
+   NODE*         first_leaf;
 
    if(str == 0)
       return 0;
@@ -924,27 +1213,40 @@ SUFFIX_TREE* ST_CreateTree(const char* str, DBL_WORD length)
       printf("\nOut of memory.\n");
       exit(0);
    }
-   heap+=sizeof(SUFFIX_TREE);
+   tree->counter        = 0;
+   tree->heap           = sizeof(SUFFIX_TREE);
+
+   /* All nodes of a previous tree in this arena are released */
+   ST_ResetArena(arena);
+   tree->arena          = arena;
+   tree->own_arena      = 0;
 
    /* Calculating string length (with an ending $ sign) */
    tree->length         = length+1;
-   ST_ERROR            = length+10;
    
-   /* Allocating the only real string of the tree */
-   tree->tree_string = malloc((tree->length+1)*sizeof(char));
-   if(tree->tree_string == 0)
+   /* The only real string of the tree is kept in the arena */
+   if(arena->string_size < tree->length+1)
    {
-      printf("\nOut of memory.\n");
-      exit(0);
+      free(arena->string);
+      arena->string_size = tree->length+1;
+      arena->string = malloc(arena->string_size*sizeof(char));
+      if(arena->string == 0)
+      {
+         printf("\nOut of memory.\n");
+         exit(0);
+      }
    }
-   heap+=(tree->length+1)*sizeof(char);
+   tree->tree_string = arena->string;
+   tree->heap+=(tree->length+1)*sizeof(char);
 
    memcpy(tree->tree_string+sizeof(char),str,length*sizeof(char));
    /* $ is considered a uniqe symbol */
    tree->tree_string[tree->length] = '$';
+
+   arena_reserve(arena, tree->length);
    
    /* Allocating the tree root node */
-   tree->root            = create_node(0, 0, 0, 0);
+   tree->root            = create_node(tree, 0, 0, 0, 0, 1);
    tree->root->suffix_link = 0;
 
    /* Initializing algorithm parameters */
@@ -952,8 +1254,9 @@ SUFFIX_TREE* ST_CreateTree(const char* str, DBL_WORD length)
    phase = 2;
    
    /* Allocating first node, son of the root (phase 0), the longest path node */
-   tree->root->sons = create_node(tree->root, 1, tree->length, 1);
-   suffixless       = 0;
+   first_leaf = create_node(tree, tree->root, 1, tree->length, 1, 0);
+   add_son(tree, tree->root, first_leaf);
+   tree->suffixless = 0;
    pos.node         = tree->root;
    pos.edge_pos     = 0;
 
@@ -966,38 +1269,12 @@ SUFFIX_TREE* ST_CreateTree(const char* str, DBL_WORD length)
    return tree;
 }
 
-/******************************************************************************/
-/*
-   ST_DeleteSubTree :
-   Deletes a subtree that is under node. It recoursively calls itself for all of
-   node's right sons and then deletes node.
-
-  Input : The node that is the root of the subtree to be deleted.
-
-  Output: None.
-*/
-
-void ST_DeleteSubTree(NODE* node)
-{
-   /* Recoursion stoping condition */
-   if(node == 0)
-      return;
-   /* Recoursive call for right sibling */
-   if(node->right_sibling!=0)
-      ST_DeleteSubTree(node->right_sibling);
-   /* Recoursive call for first son */
-   if(node->sons!=0)
-      ST_DeleteSubTree(node->sons);
-   /* Delete node itself, after its whole tree was deleted as well */
-   free(node);
-}
-
 /******************************************************************************/
 /*
    ST_DeleteTree :
-   Deletes a whole suffix tree by starting a recoursive call to ST_DeleteSubTree
-   from the root. After all of the nodes have been deleted, the function deletes
-   the structure that represents the tree.
+   Deletes a whole suffix tree. The nodes are released with the arena they were
+   taken from (if the tree owns it), then the structure that represents the
+   tree is deleted.
 
    Input : The tree to be deleted.
 
@@ -1008,8 +1285,8 @@ void ST_DeleteTree(SUFFIX_TREE* tree)
 {
    if(tree == 0)
       return;
-   ST_DeleteSubTree(tree->root);
-	free(tree->tree_string);
+   if(tree->own_arena)
+      ST_DeleteArena(tree->arena);
    free(tree);
 }
 
@@ -1029,7 +1306,8 @@ void ST_DeleteTree(SUFFIX_TREE* tree)
 
 void ST_PrintNode(SUFFIX_TREE* tree, NODE* node1, long depth)
 {
-   NODE* node2 = node1->sons;
+   NODE* node2;
+   ST_INDEX r;
    long  d = depth , start = node1->edge_label_start , end;
    end     = get_node_label_end(tree, node1);
 
@@ -1049,15 +1327,15 @@ void ST_PrintNode(SUFFIX_TREE* tree, NODE* node1, long depth)
          start++;
       }
       #ifdef DEBUG
-         printf("  \t\t\t(%lu,%lu | %lu)",node1->edge_label_start,end,node1->path_position);
+         printf("  \t\t\t(%lu,%lu | %lu)",(DBL_WORD)node1->edge_label_start,end,(DBL_WORD)node1->path_position);
       #endif
       printf("\n");
    }
-   /* Recoursive call for all node1's sons */
-   while(node2!=0)
+   /* Recoursive call for all node1's sons, in the order of their characters */
+   for(r = 0; r < node1->n_sons; r++)
    {
+      node2 = node_at(tree, tree->arena->sons[node1->sons+r]);
       ST_PrintNode(tree,node2, depth+1);
-      node2 = node2->right_sibling;
    }
 }
 
@@ -1082,8 +1360,8 @@ void ST_PrintFullNode(SUFFIX_TREE* tree, NODE* node)
    end     = get_node_label_end(tree, node);
    
    /* Stoping condition - the root */
-   if(node->father!=tree->root)
-      ST_PrintFullNode(tree,node->father);
+   if(node_at(tree, node->father)!=tree->root)
+      ST_PrintFullNode(tree,node_at(tree, node->father));
    /* Print the last edge */
    while(start<=end)
    {
@@ -1126,7 +1404,7 @@ DBL_WORD ST_SelfTest(SUFFIX_TREE* tree)
    DBL_WORD k,j,i;
 
 #ifdef STATISTICS
-   DBL_WORD old_counter = counter;
+   DBL_WORD old_counter = tree->counter;
 #endif
 
    /* Loop for all the prefixes of the tree source string */
@@ -1136,7 +1414,7 @@ DBL_WORD ST_SelfTest(SUFFIX_TREE* tree)
       for(j = 1; j<=k; j++)
       {
 #ifdef STATISTICS
-         counter = 0;
+         tree->counter = 0;
 #endif
          /* Search the current suffix in the tree */
          i = ST_FindSubstring(tree, (char*)(tree->tree_string+j), k-j+1);
@@ -1148,7 +1426,7 @@ DBL_WORD ST_SelfTest(SUFFIX_TREE* tree)
       }
    }
 #ifdef STATISTICS
-   counter = old_counter;
+   tree->counter = old_counter;
 #endif
    /* If we are here no search has failed and the test passed successfuly */
    printf("\n\nTest Results: Success.\n\n");
@@ -1171,7 +1449,8 @@ DBL_WORD ST_SelfTest(SUFFIX_TREE* tree)
 
 void ST_InitNodeHits(SUFFIX_TREE* tree, NODE* node1, long depth)
 {
-   NODE* node2 = node1->sons;
+   NODE* node2;
+   ST_INDEX r;
 
    if(depth>0)
    {
@@ -1181,11 +1460,11 @@ void ST_InitNodeHits(SUFFIX_TREE* tree, NODE* node1, long depth)
 		node1->symbol = 0;
 		/*printf("initialising node %lu\n", node1->path_position);*/
    }
-   /* Recoursive call for all node1's sons */
-   while(node2!=0)
+   /* Recoursive call for all node1's sons, in the order of their characters */
+   for(r = 0; r < node1->n_sons; r++)
    {
+      node2 = node_at(tree, tree->arena->sons[node1->sons+r]);
       ST_InitNodeHits(tree,node2, depth+1);
-      node2 = node2->right_sibling;
    }
 }
 
@@ -1226,7 +1505,8 @@ void ST_InitTreeHits(SUFFIX_TREE* tree)
 
 void ST_NodeEntropy(SUFFIX_TREE* tree, NODE* node1, long depth)
 {
-   NODE* node2 = node1->sons;
+   NODE* node2;
+   ST_INDEX r;
 
    if(depth>0)
    {
@@ -1242,11 +1522,11 @@ void ST_NodeEntropy(SUFFIX_TREE* tree, NODE* node1, long depth)
             }
 		}
    }
-   /* Recoursive call for all node1's sons */
-   while(node2!=0)
+   /* Recoursive call for all node1's sons, in the order of their characters */
+   for(r = 0; r < node1->n_sons; r++)
    {
+      node2 = node_at(tree, tree->arena->sons[node1->sons+r]);
       ST_NodeEntropy(tree,node2, depth+1);
-      node2 = node2->right_sibling;
    }
 }
 
@@ -27,39 +27,77 @@ under the same terms as Perl itself.
 /* A type definition for a 32 bits variable - a double word. */
 #define     DBL_WORD      unsigned long   
 
-/* Error return value for some functions. Initialized  in ST_CreateTree. */
-DBL_WORD    ST_ERROR;
+/* Error return value for some functions. It is larger than any index into a
+   tree string, and constant so that no global state is involved. */
+#define     ST_ERROR      ((DBL_WORD)-1)
 
 /******************************************************************************/
 /*                           DATA STRUCTURES                                  */
 /******************************************************************************/
+/* A type definition for a 32 bits node or string index. Nodes refer to each
+   other by their index into the node array of the arena, which halves the
+   size of a node compared to pointers and unsigned longs. Index 0 is never a
+   valid node and plays the role of the null pointer. */
+#define     ST_INDEX      unsigned int
+
 /* This structure describes a node and its incoming edge */
 typedef struct SUFFIXTREENODE
 {
-   /* A linked list of sons of that node */
-   struct SUFFIXTREENODE*   sons;
-   /* A linked list of right siblings of that node */
-   struct SUFFIXTREENODE*   right_sibling;
-   /* A linked list of left siblings of that node */
-   struct SUFFIXTREENODE*   left_sibling;
-   /* A pointer to that node's father */
-   struct SUFFIXTREENODE*   father;
-   /* A pointer to the node that represents the largest 
+   /* First entry of that node's block of sons in the arena (internal nodes
+      and root), 0 for a leaf. See SUFFIXTREEARENA. */
+   ST_INDEX                 sons;
+   /* Index of that node's father */
+   ST_INDEX                 father;
+   /* Index of the node that represents the largest 
    suffix of the current node */
-   struct SUFFIXTREENODE*   suffix_link;
+   ST_INDEX                 suffix_link;
    /* Index of the start position of the node's path */
-   DBL_WORD                 path_position;
+   ST_INDEX                 path_position;
    /* Start index of the incoming edge */
-   DBL_WORD                 edge_label_start;
+   ST_INDEX                 edge_label_start;
    /* End index of the incoming edge */
-   DBL_WORD                 edge_label_end;
+   ST_INDEX                 edge_label_end;
    /* A counter for search hits on this node */
    /* (C) Jens Kleinjung, London 2006) */
 	int hit;
 	float entropy;
 	_Bool symbol; /* if hit, this symbol is part of the alphabet */
+   /* Number of sons, in the padding after the fields above */
+   unsigned short           n_sons;
 } NODE;
 
+/* Number of sizes of blocks of sons, 2 to 256 sons */
+#define     ST_SON_BLOCKS 8
+
+/* This structure describes a node arena. All nodes of a tree live in one
+   array that is sized for the usual size of a tree before construction
+   starts; it only grows (and moves) between two extensions, when no node
+   pointers other than those of the construction state are held. Nodes and
+   blocks of sons are taken by a bump counter and released all at once,
+   either when the arena is reset for the next tree or when it is deleted.
+   The arena also keeps the buffer for the tree string. */
+typedef struct SUFFIXTREEARENA
+{
+   /* Node array, number of nodes taken and allocated */
+   NODE*                    node;
+   ST_INDEX                 n_node;
+   ST_INDEX                 node_size;
+   /* Blocks of sons: every internal node has a block of entries, each the
+      index of a son and the first character of the son's incoming edge,
+      sorted by that character (its rank in the alphabet). A block has room
+      for a power of two of sons, at least 2; a full block is given up for
+      one twice the size. Number of entries taken and allocated, and the
+      first given up block of each size, which links to the next one. */
+   ST_INDEX*                sons;
+   unsigned char*           son_char;
+   ST_INDEX                 n_sons;
+   DBL_WORD                 sons_size;
+   ST_INDEX                 free_sons[ST_SON_BLOCKS];
+   /* Buffer for the tree string and its allocated size */
+   char*                    string;
+   DBL_WORD                 string_size;
+} NODE_ARENA;
+
 /* This structure describes a suffix tree */
 typedef struct SUFFIXTREE
 {
@@ -80,6 +118,19 @@ typedef struct SUFFIXTREE
 	float allentropy; /* summed entropy over all nodes */
     int allsymbol; /* number of non-zero hit nodes =
                     number of symbols in alphabet to normalise entropy */
+   /* Construction state. All of it lives in the tree, so that trees can be
+      built concurrently from different threads. */
+   /* Used to mark the node that has no suffix link yet. By Ukkonen, it will
+      have one by the end of the current phase. */
+   NODE*                    suffixless;
+   /* Used for statistic measures of speed (see STATISTICS). */
+   DBL_WORD                 counter;
+   /* Used for statistic measures of space (see STATISTICS). */
+   DBL_WORD                 heap;
+   /* The arena holding all nodes and the tree string, and whether the tree
+      owns it (then it is deleted with the tree) */
+   NODE_ARENA*              arena;
+   char                     own_arena;
 } SUFFIX_TREE;
 
 
@@ -108,6 +159,33 @@ typedef struct SUFFIXTREE
 
 SUFFIX_TREE* ST_CreateTree(const char*   str, DBL_WORD length);
 
+/******************************************************************************/
+/*
+   ST_CreateTreeInArena :
+   As ST_CreateTree, but the nodes and the tree string are taken from an arena
+   provided by the caller. The arena is reset first, so any tree previously
+   built in it becomes invalid. Deleting the tree leaves the arena intact for
+   the next tree; this avoids almost all heap traffic when many trees are built
+   one after the other.
+
+   Input : The source string, its length and the arena.
+
+   Output: A pointer to the newly created tree.
+*/
+
+SUFFIX_TREE* ST_CreateTreeInArena(const char* str, DBL_WORD length, NODE_ARENA* arena);
+
+/******************************************************************************/
+/*
+   ST_CreateArena, ST_ResetArena, ST_DeleteArena :
+   Create an empty node arena, release all nodes of an arena for reuse (the
+   memory is kept) and free an arena with all its memory.
+*/
+
+NODE_ARENA* ST_CreateArena(void);
+void ST_ResetArena(NODE_ARENA* arena);
+void ST_DeleteArena(NODE_ARENA* arena);
+
 /******************************************************************************/
 /*
    ST_FindSubstring :
@@ -145,9 +223,9 @@ void ST_PrintTree(SUFFIX_TREE* tree);
 /******************************************************************************/
 /*
    ST_DeleteTree
-   Deletes a whole suffix tree by starting a recoursive call to ST_DeleteSubTree
-   from the root. After all of the nodes have been deleted, the function deletes
-   the structure that represents the tree.
+   Deletes a whole suffix tree. The nodes are released with the arena they were
+   taken from (if the tree owns it), then the structure that represents the
+   tree is deleted.
 
    Input : The tree to be deleted.
 
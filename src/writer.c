@@ -0,0 +1,143 @@
+/*==============================================================================
+writer.c : background writer of program output
+(C) 2006-2017 Jens Kleinjung
+(C) 2006-2007 Alessandro Pandini
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+==============================================================================*/
+
+
+/* Output to files and terminal is serialised by a background thread, so that
+	slow file systems do not stall the GA. Jobs carry a copy of the data they
+	write and are performed in the order of submission; a full queue blocks
+	the submitting thread until the writer has caught up. */
+
+#include <stdarg.h>
+
+#include "ga.h"
+#include "writer.h"
+
+/*____________________________________________________________________________*/
+/* writer thread: perform jobs until the queue is empty and 'stop' is set */
+static void *write_jobs(void *pw)
+{
+	Writer *writer = (Writer *)pw;
+	Writejob job;
+
+	pthread_mutex_lock(&writer->lock);
+	while (1)
+	{
+		while (writer->n_job == 0 && ! writer->stop)
+			pthread_cond_wait(&writer->queued, &writer->lock);
+		if (writer->n_job == 0)
+			break;
+
+		job = writer->job[writer->first];
+		writer->first = (writer->first + 1) % WRITER_QUEUE;
+		-- writer->n_job;
+		pthread_cond_signal(&writer->done);
+
+		pthread_mutex_unlock(&writer->lock);
+		job.write(job.data);
+		free(job.data);
+		pthread_mutex_lock(&writer->lock);
+	}
+	pthread_mutex_unlock(&writer->lock);
+
+	return 0;
+}
+
+/*____________________________________________________________________________*/
+void init_writer(Writer *writer)
+{
+	writer->first = 0;
+	writer->n_job = 0;
+	writer->stop = 0;
+	pthread_mutex_init(&writer->lock, 0);
+	pthread_cond_init(&writer->queued, 0);
+	pthread_cond_init(&writer->done, 0);
+
+	if (pthread_create(&writer->thread, 0, write_jobs, writer) != 0)
+	{
+		fprintf(stderr, "Exiting: cannot create writer thread\n");
+		exit(1);
+	}
+}
+
+/*____________________________________________________________________________*/
+/* queue job 'write' of snapshot 'data', allocated with 'safe_malloc' */
+void submit_write(Writer *writer, void (*write)(void *data), void *data)
+{
+	pthread_mutex_lock(&writer->lock);
+	while (writer->n_job == WRITER_QUEUE)
+		pthread_cond_wait(&writer->done, &writer->lock);
+
+	writer->job[(writer->first + writer->n_job) % WRITER_QUEUE].write = write;
+	writer->job[(writer->first + writer->n_job) % WRITER_QUEUE].data = data;
+	++ writer->n_job;
+	pthread_cond_signal(&writer->queued);
+	pthread_mutex_unlock(&writer->lock);
+}
+
+/*____________________________________________________________________________*/
+/* formatted text */
+typedef struct
+{
+	FILE *file;
+	char text[]; /* formatted text */
+} Text;
+
+static void write_text_job(void *data)
+{
+	Text *text = (Text *)data;
+
+	fputs(text->text, text->file);
+	fflush(text->file);
+}
+
+/* queue formatted text for 'file', flushed after writing */
+void write_text(Writer *writer, FILE *file, const char *format, ...)
+{
+	int length;
+	Text *text;
+	va_list args;
+
+	va_start(args, format);
+	length = vsnprintf(0, 0, format, args);
+	va_end(args);
+
+	text = safe_malloc(sizeof(Text) + length + 1);
+	text->file = file;
+	va_start(args, format);
+	vsnprintf(text->text, length + 1, format, args);
+	va_end(args);
+
+	submit_write(writer, write_text_job, text);
+}
+
+/*____________________________________________________________________________*/
+/* perform all queued jobs and stop the writer */
+void finish_writer(Writer *writer)
+{
+	pthread_mutex_lock(&writer->lock);
+	writer->stop = 1;
+	pthread_cond_signal(&writer->queued);
+	pthread_mutex_unlock(&writer->lock);
+	pthread_join(writer->thread, 0);
+
+	pthread_mutex_destroy(&writer->lock);
+	pthread_cond_destroy(&writer->queued);
+	pthread_cond_destroy(&writer->done);
+}
+
@@ -0,0 +1,65 @@
+/*==============================================================================
+writer.h : background writer of program output
+(C) 2006-2017 Jens Kleinjung
+(C) 2006-2007 Alessandro Pandini
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+     This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+==============================================================================*/
+
+
+#if !defined(WRITER_H)
+#define WRITER_H
+
+/*____________________________________________________________________________*/
+/* includes */
+#include <pthread.h>
+#include <stdio.h>
+
+/*____________________________________________________________________________*/
+/* defines */
+#define WRITER_QUEUE 256 /* maximal number of pending output jobs */
+
+/*____________________________________________________________________________*/
+/* structures */
+
+/* output job: 'write' serialises 'data', a snapshot owned by the job, */
+/* which the writer frees afterwards */
+typedef struct
+{
+	void (*write)(void *data);
+	void *data;
+} Writejob;
+
+/* background writer: output jobs are queued by the GA threads and */
+/* performed one after another, in the order of submission */
+typedef struct
+{
+	Writejob job[WRITER_QUEUE]; /* ring buffer of pending jobs */
+	int first; /* first pending job */
+	int n_job; /* number of pending jobs */
+	int stop; /* the writer terminates when the queue is empty */
+	pthread_mutex_t lock; /* protects the above */
+	pthread_cond_t queued; /* signals a new job or 'stop' */
+	pthread_cond_t done; /* signals a free queue slot */
+	pthread_t thread; /* writer thread */
+} Writer;
+
+/*____________________________________________________________________________*/
+/* prototypes */
+void init_writer(Writer *writer);
+void submit_write(Writer *writer, void (*write)(void *data), void *data);
+void write_text(Writer *writer, FILE *file, const char *format, ...);
+void finish_writer(Writer *writer);
+
+#endif
@@ -0,0 +1,139 @@
+#! /bin/sh
+
+echo "--------------------------------------------------------------"
+echo "MinSet reproducing seeded runs with 1 and 3 threads and 1 and 2 jobs"
+echo "--------------------------------------------------------------"
+rm -rf seeded && mkdir -p seeded/fastas && cd seeded || exit 1
+
+# base set of 40 random sequences, drawn from the background frequencies
+# of the default alphabet (TOP2006) so that subsets score positive
+awk 'BEGIN {
+	srand(1);
+	split("0.113757 0.015368 0.004562 0.087518 0.007862 0.003041 0.090818 0.006147 " \
+		"0.002653 0.104665 0.025689 0.007150 0.156950 0.041737 0.021904 0.107221 " \
+		"0.020674 0.011065 0.093536 0.020480 0.009318 0.027113 0.013459 0.007312", freq, " ");
+	for (i = 0; i < 40; ++ i) {
+		name = sprintf("s%02d", i);
+		print name > "masterfilelist";
+		seq = "";
+		for (j = 20 + int(rand() * 60); j > 0; -- j) {
+			r = rand();
+			for (c = 1; c < 24 && r >= freq[c]; ++ c)
+				r -= freq[c];
+			seq = seq substr("ABCDEFGHIJKLMNOPQRSTUVWX", c, 1);
+		}
+		printf(">%s\n%s\n", name, seq) > ("fastas/" name ".tseq");
+		close("fastas/" name ".tseq");
+	}
+}' || exit 1
+
+# all genomes of pool output file $1 select proteins and have non-zero fitness
+nonempty()
+{
+	awk '/^ *[0-9]+:/ {
+		n = 0;
+		for (i = 2; i < NF; ++ i)
+			n += $i;
+		if (n == 0 || $NF + 0 == 0)
+			bad = 1;
+		++ rows;
+	}
+	END { exit (bad || rows == 0); }' "$1" || { echo "empty genomes in $1"; exit 1; }
+}
+
+for threads in 1 3
+do
+	../../src/minset --baseset masterfilelist --popsize 200 --fitmate 20 \
+		--generation 10 --seed 11 --threads $threads --poolbin 1 --frames 5 > run.log || exit 1
+	mv 0_0.0_0.ga pool$threads.ga && mv subset.list subset$threads.list || exit 1
+	mv 0_0.0_0.pool pool$threads.pool || exit 1
+done
+
+nonempty pool1.ga
+cmp pool1.ga pool3.ga && cmp subset1.list subset3.list || exit 1
+cmp pool1.pool pool3.pool || exit 1
+
+# final pool of the binary pool file is the pool of the '.ga' file
+../../src/minset-pool pool1.pool -1 | cmp - pool1.ga || exit 1
+
+# a frame of the full pool is sorted by fitness, which differs between genomes
+../../src/minset-pool pool1.pool 0 > frame1.ga && ../../src/minset-pool pool3.pool 0 > frame3.ga || exit 1
+cmp frame1.ga frame3.ga || exit 1
+awk '/^ *[0-9]+:/ {
+	if (rows > 0 && $NF > last)
+		bad = 1;
+	if (! ($NF in seen))
+		++ distinct;
+	seen[$NF] = 1;
+	last = $NF;
+	++ rows;
+}
+END { exit (bad || rows != 200 || distinct < 2); }' frame1.ga || exit 1
+
+# base set read from a packed corpus file
+../../src/minset --baseset masterfilelist --pack corpus.bin > run.log || exit 1
+../../src/minset --corpus corpus.bin --popsize 200 --fitmate 20 \
+	--generation 10 --seed 11 > run.log || exit 1
+mv 0_0.0_0.ga corpus.ga && cmp corpus.ga pool1.ga || exit 1
+
+# base set read from one multi-record FASTA file
+cat fastas/*.tseq > baseset.fasta || exit 1
+../../src/minset --baseset baseset.fasta --popsize 200 --fitmate 20 \
+	--generation 10 --seed 11 > run.log || exit 1
+mv 0_0.0_0.ga fasta.ga && cmp fasta.ga pool1.ga || exit 1
+
+# jackknife fractions, one after another and concurrently
+for jobs in 1 2
+do
+	../../src/minset --baseset masterfilelist --popsize 200 --fitmate 20 \
+		--generation 10 --seed 11 --jackknife 2 --jobs $jobs --threads 2 > run.log || exit 1
+	mkdir jobs$jobs && mv 0_0.*.ga subset.*.list jobs$jobs || exit 1
+done
+
+for f in jobs1/*.ga
+do
+	nonempty $f
+done
+diff -r jobs1 jobs2 || exit 1
+
+# islands with migration, on different numbers of threads and jobs
+for run in "7 1" "4 2"
+do
+	set -- $run
+	../../src/minset --baseset masterfilelist --popsize 200 --fitmate 20 \
+		--generation 10 --seed 11 --islands 3 --migration 4 --jackknife 2 \
+		--threads $1 --jobs $2 > run.log || exit 1
+	mkdir islands$1 && mv 0_0.*.ga subset.*.list islands$1 || exit 1
+done
+
+for f in islands7/*.ga
+do
+	nonempty $f
+done
+diff -r islands7 islands4 || exit 1
+
+# concurrent jackknife fractions resumed from a checkpoint taken from the live run
+# reproduce the uninterrupted runs; the resumed GA takes the seed of the checkpoint
+args="--baseset masterfilelist --popsize 200 --fitmate 20 --generation 5000 \
+	--islands 2 --migration 3 --jackknife 2 --jobs 2 --checkpoint 50"
+../../src/minset $args --seed 11 > run.log &
+pid=$!
+while [ ! -f 0_0.1_1.ckpt ] && kill -0 $pid 2> /dev/null
+do
+	sleep 0.01
+done
+cp 0_0.1_1.ckpt live.checkpoint || exit 1
+kill -9 $pid
+wait $pid
+../../src/minset $args --seed 0 --resume live.checkpoint > run.log || exit 1
+grep -q "^seed  11$" parameters || exit 1
+mkdir resumed && mv 0_0.*.ga subset.*.list resumed || exit 1
+../../src/minset $args --seed 11 > run.log || exit 1
+mkdir uninterrupted && mv 0_0.*.ga subset.*.list uninterrupted || exit 1
+
+for f in resumed/*.ga
+do
+	nonempty $f
+done
+
+diff -r resumed uninterrupted || exit 1